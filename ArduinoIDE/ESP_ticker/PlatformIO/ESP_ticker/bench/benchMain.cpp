@@ -0,0 +1,426 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+#include "helperStuff.h"
+#include "jsonParser.h"
+#include "fetchStuff.h"
+#include "littlefsStuff.h"
+#include "schedStuff.h"
+#include "weerlive_nl.h"
+#include "newsapi_org.h"
+#include "noWordStuff.h"
+#include "settingStuff.h"
+#include "allDefines.h"
+
+/*
+***************************************************************************
+**  Program  : benchMain, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- Host benchmark of the parsing and text code ([env:native]):
+//--    pio run -e native && .pio.nosync/build/native/program [bench/data]
+//-- The sample weerlive and newsapi responses in bench/data are replayed
+//-- through the real fetch state machine, json scanner and message store,
+//-- settings.ini through readSettings(). Per operation it reports the
+//-- time, the number of allocations and their bytes, and the bytes written
+//-- to the (fake) LittleFS. Absolute times are host times, compare runs of
+//-- the same machine only.
+//-- First the parsed results are checked against what the samples hold,
+//-- the program exits with 1 if one of them is off.
+
+#define BENCH_MIN_US    200000    // run every case at least this long
+
+//-- a sample response, malloc()'d so it is not counted
+typedef struct _benchSample {
+  char     *data;
+  size_t    size;
+} benchSample;
+
+static const char  *benchDir = "bench/data";
+static benchSample  weerPlain, weerChunked, newsSmall, newsLarge;
+static int          benchFails = 0;
+
+static char         headline[NEWS_SIZE];
+static const char  *sampleHeadline = "Kabinet wil café\xe2\x80\x99s in Brussel \xe2\x80\x93 \xe2\x82\xac" "5 miljoen voor stikstof en woningmarkt - NOS";
+
+//-- what the samples hold
+static const char  *expectWeather = " Amersfoort Licht bewolkt  min 3\xb0" "C  max 15\xb0" "C - luchtdruk 1029.4 hPa "
+                                    " - morgen halfbewolkt  min 5\xb0" "C  max 20\xb0" "C";
+static const char  *expectTitle[] = {
+    "Premier stikstof woningmarkt eurovisie coalitie stikstof verkiezingen kamer - RTL Nieuws"
+  , "Verkiezingen rusland feyenoord provincie premier premier - NRC"
+};
+static const char  *newsRefused = "HTTP/1.1 401 Unauthorized\r\n"
+                                  "Content-Length: 0\r\n"
+                                  "\r\n";
+
+//-- the keys in the order and layout of a settings.ini that was edited by hand
+static const char  *benchIni = "Hostname = bench\r\n"
+                               "localMaxMsg = 5\r\n"
+                               "textSpeed = 30\r\n"
+                               "  maxIntensity   =  12  \r\n"
+                               "LDRlowOffset = 70\r\n"
+                               "LDRhighOffset = 700\r\n"
+                               "weerLiveAUTH = bench\r\n"
+                               "weerLiveLocatie = Amersfoort\r\n"
+                               "weerLiveInterval = 20\r\n"
+                               "newsAUTH = bench\r\n"
+                               "newsNoWords = Voetbal, show, UEFA, KNVB\r\n"
+                               "newsMaxMsg = 20\r\n"
+                               "newsInterval = 5\r\n"
+                               "playNews = 12\r\n"
+                               "oldSetting = gone\r\n"
+                               "displayModules = 8\r\n"
+                               "clockModules = 2\r\n";
+
+
+//=======================================================================
+static benchSample readSample(const char *name)
+{
+  benchSample sample;
+  char        path[200];
+  FILE       *f;
+
+  snprintf(path, sizeof(path), "%s/%s", benchDir, name);
+  f = fopen(path, "rb");
+  if (f == NULL)
+  {
+    fprintf(stderr, "cannot read [%s]\n", path);
+    exit(1);
+  }
+  fseek(f, 0, SEEK_END);
+  sample.size = ftell(f);
+  sample.data = (char*)malloc(sample.size);
+  fseek(f, 0, SEEK_SET);
+  if (sample.data == NULL || fread(sample.data, 1, sample.size, f) != sample.size)
+  {
+    fprintf(stderr, "cannot read [%s]\n", path);
+    exit(1);
+  }
+  fclose(f);
+  return sample;
+
+} // readSample()
+
+
+//=======================================================================
+static void check(bool ok, const char *what)
+{
+  if (ok) return;
+  fprintf(stderr, "CHECK FAILED: %s\n", what);
+  benchFails++;
+
+} // check()
+
+static void checkText(const char *got, const char *expected, const char *what)
+{
+  if (strcmp(got, expected) == 0) return;
+  fprintf(stderr, "CHECK FAILED: %s\n\tgot      [%s]\n\texpected [%s]\n", what, got, expected);
+  benchFails++;
+
+} // checkText()
+
+//-- slots with a headline in them
+static int newsStored()
+{
+  int stored = 0;
+
+  for (int n=0; n<=settingNewsMaxMsg; n++)
+  {
+    if (hasMessage("NWS", n)) stored++;
+  }
+  return stored;
+
+} // newsStored()
+
+static const char *newsText(uint8_t n)
+{
+  readFileById("NWS", n);
+  return fileMessage;
+
+} // newsText()
+
+
+//=======================================================================
+static void runFetch()
+{
+  while (fetchBusy()) fetchLoop();
+
+} // runFetch()
+
+static void runNews(const char *response, size_t len, bool keepOpen)
+{
+  fakeNetResponse(response, len, keepOpen);
+  getNewsapiData();
+  runFetch();
+
+} // runNews()
+
+static void benchWeerPlain()
+{
+  fakeNetResponse(weerPlain.data, weerPlain.size, true);
+  getWeerLiveData();
+  runFetch();
+}
+
+static void benchWeerChunked()
+{
+  fakeNetResponse(weerChunked.data, weerChunked.size, true);
+  getWeerLiveData();
+  runFetch();
+}
+
+static void benchNewsSmall()  { runNews(newsSmall.data, newsSmall.size, true); }
+static void benchNewsLarge()  { runNews(newsLarge.data, newsLarge.size, true); }
+
+static void benchSettingsIni()
+{
+  settingsIniChanged();     //-- no settings.bin, settings.ini is parsed
+  readSettings(false);
+}
+
+static void benchSettingsImage()
+{
+  readSettings(false);
+}
+
+static void benchSplitNoWords()
+{
+  splitNewsNoWords(settingNewsNoWords);
+}
+
+static void benchNoNoWord()
+{
+  hasNoNoWord(sampleHeadline);
+}
+
+static void benchUtf8()
+{
+  strCopy(headline, sizeof(headline), sampleHeadline);
+  utf8ToLatin1(headline);
+}
+
+static void benchWriteUnchanged()
+{
+  writeFileById("LCL", 1, "Unchanged @1@ message @4@ written again @6@ 100");
+}
+
+static void benchSplitString()
+{
+  String words[6];
+  splitString("weerlive, newsapi ,  LCL-001,NWS-002 ,,rest of the line, more", ',', words, 6);
+}
+
+static void benchStrHelpers()
+{
+  char buf[LOCAL_SIZE];
+  strCopy(buf, sizeof(buf), "   Amersfoort Centrum  ");
+  strTrim(buf, sizeof(buf), ' ');
+  strConcat(buf, sizeof(buf), " - ");
+  strConcat(buf, sizeof(buf), 21.5, 1);
+  strConcat(buf, sizeof(buf), 1029);
+  strToLower(buf);
+  strIndex(buf, "centrum");
+}
+
+static void benchCrc32()
+{
+  calcCRC32(newsLarge.data, NEWS_SIZE);
+}
+
+
+//=======================================================================
+static void checkSettings()
+{
+  File file = LittleFS.open(SETTINGS_FILE, "w");
+  file.print(benchIni);
+  file.close();
+
+  for (int pass=0; pass<2; pass++)
+  {
+    //-- pass 0 parses settings.ini, pass 1 reads the settings.bin it wrote
+    if (pass == 0) benchSettingsIni();
+    else           benchSettingsImage();
+    check(LittleFS.exists(SETTINGS_BIN),              "readSettings() writes settings.bin");
+    checkText(settingHostname, "bench",               "settings Hostname");
+    checkText(settingWeerLiveLocation, "Amersfoort",  "settings weerLiveLocatie");
+    checkText(settingNewsNoWords, "Voetbal, show, UEFA, KNVB", "settings newsNoWords");
+    check(settingTextSpeed    == 30,                  "settings textSpeed");
+    check(settingMaxIntensity == 12,                  "settings maxIntensity (spaces around it)");
+    check(settingNewsMaxMsg   == 20,                  "settings newsMaxMsg");
+    check(settingNewsInterval == 15,                  "settings newsInterval (at least 15)");
+    check(settingPlayWeight[PLAY_NEWS] == PLAY_WEIGHT_MAX, "settings playNews (at most PLAY_WEIGHT_MAX)");
+    check(settingClockModules == 2,                   "settings clockModules");
+    check(settingLDRsampleTime == 250,                "settings LDRsampleTime (default)");
+  }
+
+} // checkSettings()
+
+
+//=======================================================================
+static void checkWeather()
+{
+  char     lastWeather[LOCAL_SIZE] = "";
+  uint32_t written;
+
+  benchWeerPlain();
+  checkText(tempMessage, expectWeather, "weerlive message");
+  written = LittleFS.bytesWritten;
+  benchWeerChunked();
+  checkText(tempMessage, expectWeather, "weerlive chunked message");
+  check(LittleFS.bytesWritten == written,           "the same weather is not written again");
+  readLastWeather(lastWeather, sizeof(lastWeather));
+  checkText(lastWeather, expectWeather,             "lastWeather.txt");
+
+} // checkWeather()
+
+
+//=======================================================================
+static void checkNews()
+{
+  const char *cut;
+
+  splitNewsNoWords("");
+  benchNewsLarge();
+  check(newsStored() == settingNewsMaxMsg +1,       "newsapi 40 titles fill all slots");
+  benchNewsSmall();
+  check(newsStored() == 5,                          "newsapi 5 titles empty the slots they do not fill");
+  checkText(newsText(0), expectTitle[0],            "newsapi first title");
+  check(schedFails(SCHED_NEWS) == 0,                "newsapi complete fetch is a success");
+
+  splitNewsNoWords("Feyenoord, PSV");
+  check(hasNoNoWord(expectTitle[1]),                "hasNoNoWord() ignores case");
+  check(!hasNoNoWord(expectTitle[0]),               "hasNoNoWord() no word in it");
+  benchNewsSmall();
+  check(newsStored() == 1,                          "newsNoWords skip 4 of 5 titles");
+  checkText(newsText(0), expectTitle[0],            "newsNoWords title left");
+
+  //-- the connection drops in the third title
+  splitNewsNoWords(settingNewsNoWords);
+  cut = (const char*)memmem(newsSmall.data, newsSmall.size, "Overstroming overstroming", 25);
+  check(cut != NULL,                                "newsapi_small.http has a third title");
+  if (cut != NULL)
+  {
+    runNews(newsSmall.data, (cut - newsSmall.data), false);
+    check(newsStored() == 2,                        "cut off fetch keeps the titles it got");
+    checkText(newsText(1), expectTitle[1],          "cut off fetch second title");
+    check(schedFails(SCHED_NEWS) == 1,              "cut off fetch backs off");
+  }
+
+  //-- nothing stored and the fetch fails
+  removeNewsData();
+  runNews(newsRefused, strlen(newsRefused), true);
+  check(newsStored() == 1,                          "no news: one message");
+  checkText(newsText(1), "There is No News ....",   "no news message");
+  check(schedFails(SCHED_NEWS) == 2,                "refused fetch backs off");
+  benchNewsSmall();
+  check(newsStored() == 5,                          "headlines after no news");
+
+} // checkNews()
+
+
+//=======================================================================
+static void runBench(const char *name, void (*fn)())
+{
+  uint32_t  allocs, bytes, fsBytes, fsOpens, live;
+  uint32_t  n     = 0;
+  uint32_t  start;
+  uint32_t  took;
+
+  fn();     //-- once to warm up (first store writes, connection ..)
+
+  live                  = benchLiveBytes;
+  benchPeakBytes        = benchLiveBytes;
+  allocs                = benchAllocs;
+  bytes                 = benchAllocBytes;
+  fsBytes               = LittleFS.bytesWritten;
+  fsOpens               = LittleFS.opens;
+  start                 = micros();
+  do
+  {
+    fn();
+    n++;
+  } while ((took = (micros() - start)) < BENCH_MIN_US);
+
+  printf("%-20s %9.2f us/op %8.1f allocs/op %9.1f bytes/op %7u peak %8.1f fs-bytes/op %5.1f opens/op\n"
+                , name
+                , (double)took / n
+                , (double)(benchAllocs - allocs) / n
+                , (double)(benchAllocBytes - bytes) / n
+                , benchPeakBytes - live
+                , (double)(LittleFS.bytesWritten - fsBytes) / n
+                , (double)(LittleFS.opens - fsOpens) / n);
+
+} // runBench()
+
+
+//=======================================================================
+int main(int argc, char *argv[])
+{
+  if (argc > 1) benchDir = argv[1];
+
+  weerPlain   = readSample("weerlive.http");
+  weerChunked = readSample("weerlive_chunked.http");
+  newsSmall   = readSample("newsapi_small.http");
+  newsLarge   = readSample("newsapi_large.http");
+
+  LittleFS.begin();
+  checkSettings();
+  loadMessageCache();
+  checkWeather();
+  checkNews();
+  splitNewsNoWords(settingNewsNoWords);
+
+  runBench("readSettings ini",  benchSettingsIni);
+  runBench("readSettings image", benchSettingsImage);
+  runBench("weerlive",          benchWeerPlain);
+  runBench("weerlive chunked",  benchWeerChunked);
+  runBench("newsapi 5 titles",  benchNewsSmall);
+  runBench("newsapi 40 titles", benchNewsLarge);
+  runBench("splitNewsNoWords",  benchSplitNoWords);
+  runBench("hasNoNoWord",       benchNoNoWord);
+  runBench("writeFileById same", benchWriteUnchanged);
+  runBench("utf8ToLatin1",      benchUtf8);
+  runBench("splitString",       benchSplitString);
+  runBench("str helpers",       benchStrHelpers);
+  runBench("calcCRC32 512",     benchCrc32);
+
+  printf("\nconnects [%u], free heap [%u]\n", fakeNetConnects, ESP.getFreeHeap());
+  if (benchFails > 0)
+  {
+    fprintf(stderr, "[%d] checks FAILED\n", benchFails);
+    return 1;
+  }
+  return 0;
+
+} // main()
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
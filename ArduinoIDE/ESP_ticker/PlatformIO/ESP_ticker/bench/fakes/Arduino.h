@@ -0,0 +1,202 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/*
+***************************************************************************
+**  Program  : Arduino.h (host fake), part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- Just enough of the ESP8266 Arduino core to build the parsing, text
+//-- and fetch code on the host ([env:native], see bench/benchMain.cpp).
+//-- String keeps its text in a std::string, so every (re)allocation it
+//-- does shows up in the allocation counters of bench/fakes/fakes.cpp.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+#include "Print.h"
+
+typedef bool      boolean;
+typedef uint8_t   byte;
+
+#define F(s)            (s)
+#define PSTR(s)         (s)
+#define PROGMEM
+#define strcpy_P        strcpy
+#define strncpy_P       strncpy
+#define memcpy_P        memcpy
+
+using std::min;
+using std::max;
+
+uint32_t millis();
+uint32_t micros();
+void     delay(uint32_t ms);
+void     yield();
+
+//-- ezTime, fixed time on the host
+int   hour();
+int   minute();
+int   second();
+int   day();
+int   month();
+int   year();
+
+//=======================================================================
+class String {
+  public:
+    String()                          {}
+    String(const char *s)             : s_(s ? s : "") {}
+    String(const std::string &s)      : s_(s) {}
+    String(char c)                    : s_(1, c) {}
+    String(int v)                     : s_(std::to_string(v)) {}
+    String(unsigned int v)            : s_(std::to_string(v)) {}
+    String(long v)                    : s_(std::to_string(v)) {}
+    String(unsigned long v)           : s_(std::to_string(v)) {}
+    String(float v, int dec = 2)      { char b[40]; snprintf(b, sizeof(b), "%.*f", dec, v); s_ = b; }
+    String(double v, int dec = 2)     { char b[40]; snprintf(b, sizeof(b), "%.*f", dec, v); s_ = b; }
+
+    const char   *c_str() const       { return s_.c_str(); }
+    unsigned int  length() const      { return s_.length(); }
+    char          operator[](unsigned int i) const { return (i < s_.length()) ? s_[i] : 0; }
+    char         &operator[](unsigned int i)       { static char dummy; if (i >= s_.length()) { dummy = 0; return dummy; } return s_[i]; }
+    bool          operator==(const String &o) const { return s_ == o.s_; }
+    bool          operator!=(const String &o) const { return s_ != o.s_; }
+    String       &operator+=(const String &o)       { s_ += o.s_; return *this; }
+    String       &operator+=(const char *o)         { s_ += o; return *this; }
+    String       &operator+=(char c)                { s_ += c; return *this; }
+    friend String operator+(const String &a, const String &b) { return String(a.s_ + b.s_); }
+    friend String operator+(const String &a, const char *b)   { return String(a.s_ + b); }
+
+    int indexOf(char c, unsigned int from = 0) const
+    {
+      size_t p = s_.find(c, from);
+      return (p == std::string::npos) ? -1 : (int)p;
+    }
+    int indexOf(const String &n, unsigned int from = 0) const
+    {
+      size_t p = s_.find(n.s_, from);
+      return (p == std::string::npos) ? -1 : (int)p;
+    }
+    String substring(unsigned int from) const { return substring(from, s_.length()); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+      if (from > to) std::swap(from, to);
+      if (from >= s_.length()) return String();
+      if (to > s_.length()) to = s_.length();
+      return String(s_.substr(from, to - from));
+    }
+    void replace(const String &find, const String &repl)
+    {
+      if (find.s_.empty()) return;
+      size_t p = 0;
+      while ((p = s_.find(find.s_, p)) != std::string::npos)
+      {
+        s_.replace(p, find.s_.length(), repl.s_);
+        p += repl.s_.length();
+      }
+    }
+    void trim()
+    {
+      size_t b = s_.find_first_not_of(" \t\r\n");
+      if (b == std::string::npos) { s_.clear(); return; }
+      size_t e = s_.find_last_not_of(" \t\r\n");
+      s_ = s_.substr(b, e - b + 1);
+    }
+    void  toLowerCase() { for (auto &c : s_) c = tolower(c); }
+    long  toInt() const   { return atol(s_.c_str()); }
+    float toFloat() const { return strtof(s_.c_str(), NULL); }
+
+  private:
+    std::string s_;
+};
+
+//=======================================================================
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() { return -1; }
+
+    size_t readBytes(char *buffer, size_t length)
+    {
+      size_t n = 0;
+      while (n < length && available() > 0) buffer[n++] = read();
+      return n;
+    }
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char*)buffer, length); }
+    size_t readBytesUntil(char terminator, char *buffer, size_t length)
+    {
+      size_t n = 0;
+      while (n < length && available() > 0)
+      {
+        char c = read();
+        if (c == terminator) break;
+        buffer[n++] = c;
+      }
+      return n;
+    }
+    String readStringUntil(char terminator)
+    {
+      std::string s;
+      while (available() > 0)
+      {
+        char c = read();
+        if (c == terminator) break;
+        s += c;
+      }
+      return String(s);
+    }
+};
+
+//=======================================================================
+class EspClass {
+  public:
+    uint32_t getFreeHeap();
+    uint32_t getMaxFreeBlockSize();
+    uint8_t  getHeapFragmentation() { return 0; }
+    uint32_t getChipId()            { return 0x00BE4C; }
+};
+extern EspClass ESP;
+
+class ESP8266WebServer;
+
+
+#endif // ARDUINO_H
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
@@ -0,0 +1,93 @@
+#ifndef ESP8266WIFI_H
+#define ESP8266WIFI_H
+
+/*
+***************************************************************************
+**  Program  : ESP8266WiFi.h (host fake), part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- A WiFiClient that does not talk to a network: every request written
+//-- to it is answered by the response set with fakeNetResponse(), handed
+//-- out in pieces of at most fakeNetSegment bytes per read like TCP does.
+
+#include <Arduino.h>
+
+class IPAddress {
+  public:
+    IPAddress()                                           { b_[0] = b_[1] = b_[2] = b_[3] = 0; }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { b_[0] = a; b_[1] = b; b_[2] = c; b_[3] = d; }
+    uint8_t operator[](int i) const                       { return b_[i & 3]; }
+    String  toString() const
+    {
+      char s[16];
+      snprintf(s, sizeof(s), "%u.%u.%u.%u", b_[0], b_[1], b_[2], b_[3]);
+      return String(s);
+    }
+  private:
+    uint8_t b_[4];
+};
+
+class WiFiClient : public Stream {
+  public:
+    virtual ~WiFiClient() {}
+    virtual int     connect(IPAddress ip, uint16_t port);
+    virtual int     connect(const char *host, uint16_t port);
+    virtual uint8_t connected();
+    virtual void    stop();
+    void            setTimeout(uint32_t ms)   { (void)ms; }
+    int             available() override;
+    int             read() override;
+    int             read(uint8_t *buf, size_t size);
+    size_t          write(uint8_t c) override { return write(&c, 1); }
+    size_t          write(const uint8_t *buf, size_t size) override;
+    operator bool()                           { return connected(); }
+
+  protected:
+    bool            open_     = false;
+    size_t          pos_      = 0;      // in the response
+    bool            answered_ = false;  // a request was written
+};
+
+class ESP8266WiFiClass {
+  public:
+    int hostByName(const char *host, IPAddress &ip, uint32_t timeoutMs = 10000);
+};
+extern ESP8266WiFiClass WiFi;
+
+//-- the bench sets what the "server" answers
+void     fakeNetResponse(const char *data, size_t len, bool keepOpen);
+extern size_t   fakeNetSegment;
+extern uint32_t fakeNetConnects;
+
+
+#endif // ESP8266WIFI_H
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
@@ -0,0 +1,114 @@
+#ifndef LITTLEFS_H
+#define LITTLEFS_H
+
+/*
+***************************************************************************
+**  Program  : LittleFS.h (host fake), part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- A file system in RAM. Files are shared by all File objects opened on
+//-- them, like on the device; opens and written bytes are counted so the
+//-- bench can report flash traffic next to time and allocations.
+
+#include <Arduino.h>
+#include <memory>
+#include <map>
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Stream {
+  public:
+    File() {}
+    File(std::shared_ptr<std::string> data, bool canWrite, size_t pos)
+                  : data_(data), canWrite_(canWrite), pos_(pos) {}
+
+    operator bool() const     { return (bool)data_; }
+    int     available() override
+    {
+      return data_ ? (int)(data_->size() - pos_) : 0;
+    }
+    int     read() override
+    {
+      if (available() <= 0) return -1;
+      return (uint8_t)(*data_)[pos_++];
+    }
+    int     read(uint8_t *buf, size_t size)
+    {
+      size_t n = std::min(size, (size_t)std::max(available(), 0));
+      if (n) memcpy(buf, data_->data() + pos_, n);
+      pos_ += n;
+      return n;
+    }
+    size_t  write(uint8_t c) override           { return write(&c, 1); }
+    size_t  write(const uint8_t *buf, size_t size) override;
+    bool    seek(uint32_t pos, SeekMode mode = SeekSet)
+    {
+      if (!data_) return false;
+      if (mode == SeekCur) pos += pos_;
+      if (mode == SeekEnd) pos += data_->size();
+      if (pos > data_->size()) return false;
+      pos_ = pos;
+      return true;
+    }
+    size_t  size() const      { return data_ ? data_->size() : 0; }
+    size_t  position() const  { return pos_; }
+    void    close()           { data_.reset(); }
+
+  private:
+    std::shared_ptr<std::string> data_;
+    bool                         canWrite_ = false;
+    size_t                       pos_      = 0;
+};
+
+//-- only for fsDir of platformStuff.h, there are no directories
+class Dir {};
+
+class FS {
+  public:
+    bool begin()              { return true; }
+    File open(const char *path, const char *mode);
+    bool exists(const char *path);
+    bool remove(const char *path);
+    bool rename(const char *from, const char *to);
+    void format()             { files_.clear(); }
+
+    uint32_t  opens         = 0;
+    uint32_t  bytesWritten  = 0;
+
+  private:
+    std::map<std::string, std::shared_ptr<std::string>> files_;
+};
+extern FS LittleFS;
+
+
+#endif // LITTLEFS_H
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
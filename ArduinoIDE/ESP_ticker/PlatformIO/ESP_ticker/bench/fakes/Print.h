@@ -0,0 +1,84 @@
+#ifndef PRINT_H
+#define PRINT_H
+
+/*
+***************************************************************************
+**  Program  : Print.h (host fake), part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+class String;
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+      size_t n = 0;
+      while (size--) n += write(*buffer++);
+      return n;
+    }
+    virtual void flush() {}
+
+    size_t print(const char *s)   { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(char c)          { return write((uint8_t)c); }
+    size_t print(int v)           { char b[12]; snprintf(b, sizeof(b), "%d", v); return print(b); }
+    size_t print(unsigned int v)  { char b[12]; snprintf(b, sizeof(b), "%u", v); return print(b); }
+    size_t print(long v)          { char b[24]; snprintf(b, sizeof(b), "%ld", v); return print(b); }
+    size_t print(unsigned long v) { char b[24]; snprintf(b, sizeof(b), "%lu", v); return print(b); }
+    size_t print(double v)        { char b[40]; snprintf(b, sizeof(b), "%.2f", v); return print(b); }
+    size_t print(const String &s);
+    size_t println()              { return print("\r\n"); }
+    template <typename T>
+    size_t println(T v)           { size_t n = print(v); return n + println(); }
+    size_t printf(const char *fmt, ...) __attribute__ ((format (printf, 2, 3)))
+    {
+      char    buf[256];
+      va_list args;
+      va_start(args, fmt);
+      int len = vsnprintf(buf, sizeof(buf), fmt, args);
+      va_end(args);
+      if (len < 0) return 0;
+      if (len >= (int)sizeof(buf)) len = sizeof(buf) -1;
+      return write((const uint8_t*)buf, len);
+    }
+};
+
+
+#endif // PRINT_H
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
@@ -0,0 +1,78 @@
+#ifndef WIFICLIENTSECUREBEARSSL_H
+#define WIFICLIENTSECUREBEARSSL_H
+
+/*
+***************************************************************************
+**  Program  : WiFiClientSecureBearSSL.h (host fake), part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- no TLS on the host: the secure client is the plain fake client,
+//-- every handshake succeeds with max fragment length
+
+#include <ESP8266WiFi.h>
+
+#define BR_ERR_TOO_LARGE  18
+
+namespace BearSSL {
+
+class Session {
+};
+
+class X509List {
+  public:
+    X509List(const char *pem)               { count_ = (strstr(pem, "-----BEGIN") != NULL); }
+    size_t getCount() const                 { return count_; }
+  private:
+    size_t count_;
+};
+
+class WiFiClientSecureCtx : public WiFiClient {
+  public:
+    void setSession(Session *session)           { (void)session; }
+    void setBufferSizes(int recv, int xmit)     { (void)recv; (void)xmit; }
+    void setTrustAnchors(const X509List *ta)    { (void)ta; }
+    void setX509Time(time_t now)                { (void)now; }
+    bool getMFLNStatus()                        { return true; }
+    int  getLastSSLError(char *dest = NULL, size_t len = 0)
+    {
+      if (dest != NULL && len > 0) dest[0] = '\0';
+      return 0;
+    }
+  protected:
+    bool _connectSSL(const char *hostName)      { (void)hostName; return true; }
+};
+
+} // namespace BearSSL
+
+
+#endif // WIFICLIENTSECUREBEARSSL_H
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
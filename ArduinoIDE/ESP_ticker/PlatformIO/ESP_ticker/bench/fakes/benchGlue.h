@@ -0,0 +1,59 @@
+#ifndef BENCHGLUE_H
+#define BENCHGLUE_H
+
+/*
+***************************************************************************
+**  Program  : benchGlue.h, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- Included in front of every file of [env:native] (-include). On the
+//-- device these globals come from ESP_ticker.h and Debug.h, which pull
+//-- in Parola, ezTime and WiFiManager, so the bench defines its own in
+//-- bench/fakes/fakes.cpp.
+
+#include <Arduino.h>
+
+extern char     cDate[], cTime[];
+extern char     tempMessage[];
+extern char     settingWeerLiveAUTH[], settingWeerLiveLocation[];
+extern char     settingNewsAUTH[];
+extern uint8_t  settingNewsMaxMsg;
+
+//-- allocation counters, kept by the operator new/delete of fakes.cpp
+extern uint32_t benchAllocs;
+extern uint32_t benchAllocBytes;
+extern uint32_t benchLiveBytes;
+extern uint32_t benchPeakBytes;
+
+
+#endif // BENCHGLUE_H
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
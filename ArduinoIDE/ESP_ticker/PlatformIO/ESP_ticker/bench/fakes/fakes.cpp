@@ -0,0 +1,296 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+#include <chrono>
+#include <new>
+#include "logStuff.h"
+#include "metricsStuff.h"
+#include "platformStuff.h"
+#include "allDefines.h"
+
+/*
+***************************************************************************
+**  Program  : fakes, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- host side of the fake core, file system and network plus the sketch
+//-- globals the modules of [env:native] use (see benchGlue.h)
+
+//-- heap the bench pretends to have, ESP.getFreeHeap() is this minus
+//-- what is allocated right now
+#define FAKE_HEAP_SIZE  40000
+
+EspClass          ESP;
+ESP8266WiFiClass  WiFi;
+FS                LittleFS;
+logStream         DebugLog;
+
+char      cDate[15], cTime[10];
+uint32_t  nrReboots;
+char      tempMessage[LOCAL_SIZE] = "";
+char      fileMessage[LOCAL_SIZE];
+uint8_t   settingLocalMaxMsg  = 5;
+char      settingWeerLiveAUTH[51]     = "bench";
+char      settingWeerLiveLocation[51] = "Amersfoort";
+char      settingNewsAUTH[51]         = "bench";
+uint8_t   settingNewsMaxMsg   = 20;
+//-- set by readSettings() from the bench's settings.ini
+char      settingHostname[41];
+char      settingNewsNoWords[LOCAL_SIZE];
+uint8_t   settingTextSpeed, settingMaxIntensity;
+uint16_t  settingLDRlowOffset, settingLDRhighOffset;
+uint16_t  settingLDRsampleTime;
+uint8_t   settingLDRsmoothing;
+uint8_t   settingWeerLiveInterval;
+uint8_t   settingNewsInterval;
+uint8_t   settingPlayWeight[PLAY_SOURCES];
+uint8_t   settingDisplayModules;
+uint8_t   settingClockModules;
+
+uint32_t  benchAllocs     = 0;
+uint32_t  benchAllocBytes = 0;
+uint32_t  benchLiveBytes  = 0;
+uint32_t  benchPeakBytes  = 0;
+
+size_t    fakeNetSegment  = NET_CHUNK_SIZE;
+uint32_t  fakeNetConnects = 0;
+static bool        countAllocs = true;  // off while the fakes allocate
+static const char *netData     = NULL;
+static size_t      netLen      = 0;
+static bool        netKeepOpen = true;
+
+
+//=======================================================================
+//-- every allocation goes through here, the size is kept in front of it
+struct allocHeader { size_t size; size_t pad; };
+
+static void *countedAlloc(size_t size)
+{
+  allocHeader *h = (allocHeader*)malloc(sizeof(allocHeader) + size);
+  if (h == NULL) throw std::bad_alloc();
+  h->size = size;
+  if (!countAllocs)
+  {
+    h->pad = 1;     //-- not in benchLiveBytes either
+    return (h +1);
+  }
+  h->pad = 0;
+  benchAllocs++;
+  benchAllocBytes += size;
+  benchLiveBytes  += size;
+  if (benchLiveBytes > benchPeakBytes) benchPeakBytes = benchLiveBytes;
+  return (h +1);
+}
+
+static void countedFree(void *p)
+{
+  if (p == NULL) return;
+  allocHeader *h = ((allocHeader*)p) -1;
+  if (h->pad == 0) benchLiveBytes -= h->size;
+  free(h);
+}
+
+void *operator new(size_t size)                     { return countedAlloc(size); }
+void *operator new[](size_t size)                   { return countedAlloc(size); }
+void  operator delete(void *p) noexcept             { countedFree(p); }
+void  operator delete[](void *p) noexcept           { countedFree(p); }
+void  operator delete(void *p, size_t) noexcept     { countedFree(p); }
+void  operator delete[](void *p, size_t) noexcept   { countedFree(p); }
+
+//-- what the fake file system allocates is not the firmware's doing
+struct notCounted {
+  notCounted()  { countAllocs = false; }
+  ~notCounted() { countAllocs = true; }
+};
+
+
+//=======================================================================
+static const auto bootTime = std::chrono::steady_clock::now();
+
+uint32_t micros()
+{
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - bootTime).count();
+}
+uint32_t millis()           { return micros() / 1000; }
+void     delay(uint32_t ms) { uint32_t s = millis(); while ((millis() - s) < ms) ; }
+void     yield()            {}
+
+int hour()    { return 12; }
+int minute()  { return 0; }
+int second()  { return 0; }
+int day()     { return 1; }
+int month()   { return 1; }
+int year()    { return 2023; }
+
+uint32_t EspClass::getFreeHeap()          { return FAKE_HEAP_SIZE - std::min(benchLiveBytes, (uint32_t)FAKE_HEAP_SIZE); }
+uint32_t EspClass::getMaxFreeBlockSize()  { return getFreeHeap(); }
+
+size_t Print::print(const String &s)      { return print(s.c_str()); }
+
+
+//=======================================================================
+//-- the log goes nowhere, formatting it is part of what is measured
+size_t logStream::write(uint8_t c)                          { (void)c; return 1; }
+size_t logStream::write(const uint8_t *buffer, size_t size) { (void)buffer; return size; }
+uint32_t logLost()                                          { return 0; }
+
+void _debugBOL(const char *fn, int line)
+{
+  char bol[128];
+  snprintf(bol, sizeof(bol), "[%02d:%02d:%02d][%7u|%6u] %-12.12s(%4d): "
+                           , hour(), minute(), second()
+                           , ESP.getFreeHeap(), ESP.getMaxFreeBlockSize()
+                           , fn, line);
+  DebugLog.print(bol);
+}
+
+void platformMdnsHostname(const char *hostname)
+{
+  (void)hostname;
+}
+
+void metricsFetchDone(uint8_t provider, uint32_t durationMs, bool ok)
+{
+  (void)provider; (void)durationMs; (void)ok;
+}
+void metricsFsOp(bool isWrite, uint32_t startMicros)
+{
+  (void)isWrite; (void)startMicros;
+}
+
+
+//=======================================================================
+void fakeNetResponse(const char *data, size_t len, bool keepOpen)
+{
+  netData     = data;
+  netLen      = len;
+  netKeepOpen = keepOpen;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+  (void)ip; (void)port;
+  fakeNetConnects++;
+  open_     = true;
+  answered_ = false;
+  pos_      = 0;
+  return 1;
+}
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+  (void)host;
+  return connect(IPAddress(127, 0, 0, 1), port);
+}
+uint8_t WiFiClient::connected()
+{
+  if (!open_) return 0;
+  //-- a server without keep-alive closes after the last byte
+  return (netKeepOpen || !answered_ || pos_ < netLen);
+}
+void WiFiClient::stop() { open_ = false; }
+
+int WiFiClient::available()
+{
+  if (!open_ || !answered_ || pos_ >= netLen) return 0;
+  return (int)std::min(netLen - pos_, fakeNetSegment);
+}
+int WiFiClient::read()
+{
+  if (available() <= 0) return -1;
+  return (uint8_t)netData[pos_++];
+}
+int WiFiClient::read(uint8_t *buf, size_t size)
+{
+  size_t n = std::min(size, (size_t)available());
+  memcpy(buf, &netData[pos_], n);
+  pos_ += n;
+  return n;
+}
+size_t WiFiClient::write(const uint8_t *buf, size_t size)
+{
+  (void)buf;
+  //-- the request is not looked at, the answer starts from the top
+  answered_ = true;
+  pos_      = 0;
+  return size;
+}
+
+int ESP8266WiFiClass::hostByName(const char *host, IPAddress &ip, uint32_t timeoutMs)
+{
+  (void)host; (void)timeoutMs;
+  ip = IPAddress(127, 0, 0, 1);
+  return 1;
+}
+
+
+//=======================================================================
+size_t File::write(const uint8_t *buf, size_t size)
+{
+  if (!data_ || !canWrite_) return 0;
+  notCounted quiet;
+  if (pos_ + size > data_->size()) data_->resize(pos_ + size);
+  memcpy(&(*data_)[pos_], buf, size);
+  pos_ += size;
+  LittleFS.bytesWritten += size;
+  return size;
+}
+
+File FS::open(const char *path, const char *mode)
+{
+  notCounted quiet;
+  auto       it = files_.find(path);
+  opens++;
+  if (mode[0] == 'r')
+  {
+    if (it == files_.end()) return File();
+    return File(it->second, (mode[1] == '+'), 0);
+  }
+  if (it == files_.end() || mode[0] == 'w')
+  {
+    files_[path] = std::make_shared<std::string>();
+    it = files_.find(path);
+  }
+  return File(it->second, true, (mode[0] == 'a') ? it->second->size() : 0);
+}
+bool FS::exists(const char *path)  { notCounted quiet; return files_.count(path) > 0; }
+bool FS::remove(const char *path)  { notCounted quiet; return files_.erase(path) > 0; }
+bool FS::rename(const char *from, const char *to)
+{
+  notCounted quiet;
+  auto       it = files_.find(from);
+  if (it == files_.end()) return false;
+  files_[to] = it->second;
+  files_.erase(from);
+  return true;
+}
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
@@ -46,6 +46,7 @@
     refreshDevTime();
     refreshDevInfo();
     refreshMessages();
+    startEvents();
 
     document.getElementById("displayMainPage").style.display       = "block";
     document.getElementById("displaySettingsPage").style.display   = "none";
@@ -89,6 +90,38 @@
   } // refreshDevTime()
     
   
+  //============================================================================  
+  //-- after the first load the ticker pushes what changes (api/v0/events)
+  function startEvents()
+  {
+    if (!window.EventSource) return;
+    
+    let events = new EventSource(APIGW+"v0/events");
+    events.addEventListener('time', function(e) {
+        document.getElementById('theTime').innerHTML = JSON.parse(e.data).value;
+      });
+    events.addEventListener('message', function(e) {
+        document.getElementById('message').textContent = JSON.parse(e.data).value;
+      });
+    events.addEventListener('local', function(e) {
+        let msg   = JSON.parse(e.data);
+        let input = document.getElementById("M_"+msg.name);
+        //-- not while it is being edited
+        if (input != null && input.style.background != "lightgray") input.value = msg.value;
+      });
+    events.addEventListener('setting', function(e) {
+        let setting = JSON.parse(e.data);
+        let inputs  = document.getElementById('settingsPage').getElementsByTagName('input');
+        for (let i=0; i<inputs.length; i++)
+        {
+          if (inputs[i].id.toLowerCase() != setting.name.toLowerCase()) continue;
+          if (inputs[i].style.background != "lightgray") inputs[i].value = setting.value;
+        }
+      });
+    
+  } // startEvents()
+    
+  
   //============================================================================  
   function refreshDevInfo()
   {
@@ -491,6 +524,8 @@
           ,[ "maxIntensity",      "max. Intensiteit leds" ]
           ,[ "LDRlowOffset",      "LDR min. waarde" ]
           ,[ "LDRhighOffset",     "LDR max. waarde" ]
+          ,[ "LDRsampleTime",     "LDR meet interval in ms" ]
+          ,[ "LDRsmoothing",      "LDR demping (1 = geen)" ]
           ,[ "weerliveAUTH",      "weerlive.nl auth. token" ]
           ,[ "weerliveLocation",  "weerlive.nl locatie" ]
           ,[ "weerliveInterval",  "weerlive.nl refresh interval in minuten" ]
@@ -0,0 +1,64 @@
+#
+#  gzipAssets.py - PlatformIO (pre) extra_script for ESP_ticker
+#
+#  Puts a gzip'ed copy next to every web asset in 'data/' so the
+#  LittleFS image ("Build/Upload Filesystem Image") holds both.
+#  assetStuff.cpp serves the '.gz' version when it exists.
+#  The index page (html/indexPage.html) is built into the firmware: it
+#  goes gzip'ed, with its ETag, into 'include/indexPageGz.h'.
+#
+#  Copyright (c) 2023 Willem Aandewiel
+#
+#  TERMS OF USE: MIT License.
+#
+import gzip
+import os
+import zlib
+
+Import("env")
+
+GZIP_FILES = ["index.js", "index.css", "FSexplorer.html", "FSexplorer.css"]
+INDEX_PAGE = os.path.join("html", "indexPage.html")
+INDEX_HDR  = "indexPageGz.h"
+
+
+def gzip_assets(*args, **kwargs):
+  data_dir = env.subst("$PROJECT_DATA_DIR")
+  for name in GZIP_FILES:
+    src = os.path.join(data_dir, name)
+    dst = src + ".gz"
+    if not os.path.isfile(src):
+      continue
+    if os.path.isfile(dst) and os.path.getmtime(dst) >= os.path.getmtime(src):
+      continue
+    with open(src, "rb") as f_in:
+      raw = f_in.read()
+    #-- mtime=0 so the same input always gives the same file (and ETag)
+    with open(dst, "wb") as f_out:
+      f_out.write(gzip.compress(raw, compresslevel=9, mtime=0))
+    print("gzipAssets: %s (%d -> %d bytes)" % (name, len(raw), os.path.getsize(dst)))
+
+
+def gzip_index_page(*args, **kwargs):
+  src = os.path.join(env.subst("$PROJECT_DIR"), INDEX_PAGE)
+  dst = os.path.join(env.subst("$PROJECT_INCLUDE_DIR"), INDEX_HDR)
+  if os.path.isfile(dst) and os.path.getmtime(dst) >= os.path.getmtime(src):
+    return
+  with open(src, "rb") as f_in:
+    raw = f_in.read()
+  packed = gzip.compress(raw, compresslevel=9, mtime=0)
+  lines = []
+  lines.append("//-- generated by gzipAssets.py from %s, do not edit" % INDEX_PAGE.replace(os.sep, "/"))
+  lines.append("#define INDEX_PAGE_ETAG  \"\\\"%08x\\\"\"" % zlib.crc32(packed))
+  lines.append("")
+  lines.append("static const uint8_t indexPageGz[] PROGMEM = {")
+  for i in range(0, len(packed), 16):
+    lines.append("  " + ", ".join("0x%02x" % b for b in packed[i:i+16]) + ",")
+  lines.append("};")
+  with open(dst, "w") as f_out:
+    f_out.write("\n".join(lines) + "\n")
+  print("gzipAssets: %s (%d -> %d bytes)" % (INDEX_PAGE, len(raw), len(packed)))
+
+
+gzip_assets()
+gzip_index_page()
@@ -11,6 +11,10 @@
 #ifndef DEBUG_H
 #define DEBUG_H
 
+#include "logStuff.h"
+#include "platformStuff.h"
+#include "timeStuff.h"
+
 /*---- start macro's ------------------------------------------------------------------*/
 
 //-- moved to allDefines.h // #define Debug(...)      ({ Serial.print(__VA_ARGS__);         \
@@ -36,16 +40,16 @@
 
 /*---- einde macro's ------------------------------------------------------------------*/
 
-char _bol[128];
 void _debugBOL(const char *fn, int line)
 {
+  char _bol[128];   //-- on the stack, on the ESP32 both cores log
    
   snprintf(_bol, sizeof(_bol), "[%02d:%02d:%02d][%7u|%6u] %-12.12s(%4d): ", \
-                hour(), minute(), second(), \
-                ESP.getFreeHeap(), ESP.getMaxFreeBlockSize(),\
+                clockHour(), clockMinute(), clockSecond(), \
+                ESP.getFreeHeap(), platformMaxFreeBlock(),\
                 fn, line);
                  
-  Serial.print (_bol);
+  DebugLog.print(_bol);
 }
 
 /***************************************************************************
@@ -1,7 +1,8 @@
 #ifndef ESP_TICKER_H
 #define ESP_TICKER_H
 
-#include <ESP8266WiFi.h>
+#include <sys/time.h>           // settimeofday()
+#include "platformStuff.h"
 #include <LittleFS.h>
 #include <ezTime.h>             // https://github.com/ropg/ezTime
 #include "Debug.h"
@@ -9,6 +10,9 @@
 #include <MD_Parola.h>
 #include <MD_MAX72xx.h>
 #include "parola_Fonts_data.h"
+#include "queueStuff.h"
+#include "schedStuff.h"
+#include "noWordStuff.h"
 #include <SPI.h>
 #include <Arduino.h>
 
@@ -42,7 +46,6 @@
 //-- moved to allDefines.h // #define LOCAL_SIZE      255
 //-- moved to allDefines.h // #define NEWS_SIZE       512
 //-- moved to allDefines.h // #define JSON_BUFF_MAX   255
-//-- moved to allDefines.h // #define MAX_NO_NO_WORDS  20
 
 bool      Verbose = false;
 char      cDate[15], cTime[10];
@@ -50,28 +53,31 @@ uint32_t  nrReboots;
 // Global message buffers shared by Wifi and Scrolling functions
 char      cMsg[NEWS_SIZE];
 char      tempMessage[LOCAL_SIZE] = "";
-uint8_t   msgType;
-char      actMessage[NEWS_SIZE], timeMsg[20];
+char      timeMsg[20];
+char     *actMessage  = (char*)"";      // on the display, a queueStuff entry
 char      fileMessage[LOCAL_SIZE];
 uint8_t   newsMsgID   = 0;
 uint8_t   localMsgID  = 0;
 int16_t   valueLDR, valueIntensity;
 char      fChar[10];
 String    lastReset   = "";
-uint32_t  timeTimer   = 0;
 uint32_t  ntpTimer    = millis() + 30000;
-uint32_t  weerTimer   = 0;
-uint32_t  newsapiTimer = 0;
-uint32_t  revisionTimer = 0;
-String    noWords[MAX_NO_NO_WORDS+1];
+uint8_t   bootStatus  = 0;        // BOOT_xx bits, set by bootLoop()
+bool      showIPaddress = false;
+uint32_t  firstScrollMs = 0;      // millis() at the first message of loop()
 char      settingHostname[41];
 char      settingNewsNoWords[LOCAL_SIZE];
 uint8_t   settingLocalMaxMsg, settingTextSpeed, settingMaxIntensity;
 uint16_t  settingLDRlowOffset, settingLDRhighOffset;
+uint16_t  settingLDRsampleTime;
+uint8_t   settingLDRsmoothing;
 char      settingWeerLiveAUTH[51], settingWeerLiveLocation[51];
 uint8_t   settingWeerLiveInterval;
 char      settingNewsAUTH[51];
 uint8_t   settingNewsInterval, settingNewsMaxMsg;
+uint8_t   settingPlayWeight[PLAY_SOURCES];
+uint8_t   settingDisplayModules = MAX_DEVICES;
+uint8_t   settingClockModules   = 0;
 
 Timezone  CET;
 
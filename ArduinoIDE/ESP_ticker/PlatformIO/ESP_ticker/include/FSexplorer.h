@@ -8,6 +8,9 @@
 #include "ESP_ticker.h"
 #include "sendIndexPage.h"
 #include "restAPI.h"
+#include "assetStuff.h"
+#include "settingStuff.h"
+#include "sysLogStuff.h"
 #include "allDefines.h"
 
 //== Extern Variables ==
@@ -22,7 +25,8 @@ bool handleFile(String&& path);
 void handleFileUpload();
 void formatLittleFS();
 const String formatBytes(size_t const& bytes);
-bool freeSpace(uint16_t const& printsize);
+const String &contentType(String& filename);
+bool freeSpace(uint32_t needed);
 void updateFirmware();
 void reBootESP();
 void doRedirect(String msg, int wait, const char* URL, bool reboot);
@@ -1,54 +1,171 @@
 #ifndef ALLDEFINES_H
 #define ALLDEFINES_H
 
-#define Debug(...)      ({ Serial.print(__VA_ARGS__);         \
-                        })
+#include "logStuff.h"
 
-#define Debugln(...)    ({ Serial.println(__VA_ARGS__);       \
-                        })
+//-- all Debug..() output goes to the log ring buffer (see logStuff), a
+//-- statement above LOG_MODULE_LEVEL compiles to nothing
+#define LOG_IF(lvl, ...)  ({ if (LOG_MODULE_LEVEL >= (lvl)) { __VA_ARGS__; } \
+                          })
 
-#define Debugf(...)     ({ Serial.printf(__VA_ARGS__);        \
-                        })
+#define Debug(...)      LOG_IF(LOG_LEVEL_DEBUG, DebugLog.print(__VA_ARGS__))
 
-#define DebugFlush()    ({ Serial.flush(); \
-                        })
+#define Debugln(...)    LOG_IF(LOG_LEVEL_DEBUG, DebugLog.println(__VA_ARGS__))
 
-#define DebugT(...)     ({ _debugBOL(__FUNCTION__, __LINE__);  \
-                           Debug(__VA_ARGS__);                 \
-                        })
+#define Debugf(...)     LOG_IF(LOG_LEVEL_DEBUG, DebugLog.printf(__VA_ARGS__))
 
-#define DebugTln(...)   ({ _debugBOL(__FUNCTION__, __LINE__);  \
-                           Debugln(__VA_ARGS__);        \
+#define DebugFlush()    ({ logFlush(); \
                         })
 
-#define DebugTf(...)    ({ _debugBOL(__FUNCTION__, __LINE__);  \
-                           Debugf(__VA_ARGS__);                \
-                        })
+#define DebugT(...)     LOG_IF(LOG_LEVEL_DEBUG, _debugBOL(__FUNCTION__, __LINE__);  \
+                                                DebugLog.print(__VA_ARGS__))
+
+#define DebugTln(...)   LOG_IF(LOG_LEVEL_DEBUG, _debugBOL(__FUNCTION__, __LINE__);  \
+                                                DebugLog.println(__VA_ARGS__))
+
+#define DebugTf(...)    LOG_IF(LOG_LEVEL_DEBUG, _debugBOL(__FUNCTION__, __LINE__);  \
+                                                DebugLog.printf(__VA_ARGS__))
+
+#define InfoTf(...)     LOG_IF(LOG_LEVEL_INFO,  _debugBOL(__FUNCTION__, __LINE__);  \
+                                                DebugLog.printf(__VA_ARGS__))
+
+#define ErrorTf(...)    LOG_IF(LOG_LEVEL_ERROR, _debugBOL(__FUNCTION__, __LINE__);  \
+                                                DebugLog.printf(__VA_ARGS__))
+
+//-- the time and heap in front of a line, see Debug.h
+void _debugBOL(const char *fn, int line);
 
 #define HARDWARE_TYPE MD_MAX72XX::FC16_HW
 
-#define MAX_DEVICES  8
+#define MAX_DEVICES  8        // the most modules driven, settingDisplayModules are used
+
+#define ZONE_MSG     0        // the scrolling zone
+#define ZONE_CLOCK   1        // only when settingClockModules > 0
 
 #define MAX_SPEED   50
 
-#define CS_PIN      15 // or SS
+#define LDR_HYSTERESIS  10
+
+#if defined(ESP32)
+  #define CS_PIN     5 // VSPI SS
+#else
+  #define CS_PIN      15 // or SS
+#endif
 
 #define SETTINGS_FILE   "/settings.ini"
 
+#define SETTINGS_BIN    "/settings.bin"
+
+#define SETTINGS_IMAGE_MAX  512   // >= all settings together, static_assert in settingStuff.cpp
+
+#define WEATHER_FILE    "/lastWeather.txt"
+
+#define SYSLOG_DIR          "/sysLog"
+#define SYSLOG_LEGACY       "/sysLog.csv"   // the old unbounded log, its tail becomes a segment
+#define SYSLOG_SEGMENT_SIZE   4096  // bytes per segment file (about)
+#define SYSLOG_SEGMENTS          4  // segments kept, the log is capped at their total
+#define SYSLOG_STAGE_SIZE     1024  // RAM stage in front of the segments
+#define SYSLOG_FLUSH_SIZE      768  // a stage this full is written
+#define SYSLOG_FLUSH_MS      60000  // a line waits at most this long in RAM
+#define SYSLOG_LINE_MAX        150
+#define REBOOT_DELAY          5000  // ms for the reply to go out before a restart
+
+#define BOOT_WIFI         0x01
+#define BOOT_MDNS         0x02
+#define BOOT_HTTP         0x04
+#define BOOT_NTP          0x08
+#define BOOT_PORTAL       0x10
+#define BOOT_WIFI_TIMEOUT 15000   // ms before the WiFiManager portal is started
+
 #define LOCAL_SIZE      255
 
 #define NEWS_SIZE       512
+#if defined(ESP32)
+  #define QUEUE_DEPTH   4     // power of 2, QUEUE_PREPARED and room for an urgent cut in
+#else
+  #define QUEUE_DEPTH   2     // prepared messages, incl. the one on the display (power of 2)
+#endif
+#define QUEUE_PREPARED  2     // the one on the display and the next
 
 #define JSON_BUFF_MAX   255
 
-#define MAX_NO_NO_WORDS  20
+#define NET_CHUNK_SIZE  536
+
+#define FETCH_PATH_MAX  200
+
+#define FETCH_LINE_MAX   80
+
+#define FETCH_TIMEOUT         5000
+
+#define FETCH_CONNECT_TIMEOUT 3000
+
+#define FETCH_DNS_TTL       600000  // ms a resolved address is used
+
+#define FETCH_KEEPALIVE      20000  // ms an idle connection is kept open
+
+#define FETCH_TLS_RX_SIZE     1024  // with max fragment length
+#define FETCH_TLS_RX_FALLBACK 8192  // server refused it: 16384 leaves no heap
+
+#define FETCH_CLOCK_VALID   1672531200  // 2023-01-01, before it certificates can not be checked
+
+#define TRUST_ANCHORS_FILE  "/trustAnchors.pem"   // replaces the built in root certificates
+#define TLS_NO_MFLN_FILE    "/tlsNoMfln.txt"      // hosts that refused max fragment length
+
+#define NO_WORD_NODES   LOCAL_SIZE
+
+#define MAX_MSG_SLOTS    21
+
+#define MSG_CACHE_SIZE 4096
+
+#define PLAY_CLOCK        0   // weekday followed by the time
+#define PLAY_LOCAL        1
+#define PLAY_NEWS         2
+#define PLAY_WEATHER      3
+#define PLAY_SOURCES      4
+#define PLAY_URGENT       PLAY_SOURCES  // not in the playlist, see playlistNext()
+#define PLAY_NONE         0xFF          // not from the playlist (IP address)
+#define PLAY_WEIGHT_MAX   9
+#define PLAYLIST_MAX      (PLAY_SOURCES * PLAY_WEIGHT_MAX)
+#define PLAY_URGENT_EVERY 3   // an urgent message is at least every 3rd item
+
+#define PUSH_VIEWERS      3   // browsers on /api/v0/events at the same time
+#define PUSH_KEEPALIVE    15000 // ms between keep-alive comments
+
+#define SCHED_WEATHER     0   // started from loop()
+#define SCHED_NEWS        1   // started from loop()
+#define SCHED_FETCHES     2   // the ones above, schedIdleMs() looks at these
+#define SCHED_REVISION    2   // checked by nextLocalBericht()
+#define SCHED_CLOCK       3   // checked by prepareNextMessage()
+#define SCHED_TASKS       4
+#define SCHED_START_JITTER  10000  // ms, spreads the first fetch of devices that boot together
+#define SCHED_RETRY_MIN     15000  // ms after the first failure, doubles every next one
+#define SCHED_RETRY_MAX   1800000  // ms, most between retries (and for tasks without period)
+#define SCHED_OFF_CHECK     60000  // ms, a task that is switched off looks again
+#define SCHED_IDLE_MIN         20  // ms to the next fetch before loop() gives a ms away
 
 #define _FW_VERSION "v1.7.3 (04-05-2023)"
 
 #define USE_UPDATE_SERVER
 
+//-- [env:esp32]: the ESP8266 name of the webserver is used everywhere
+#if defined(ESP32)
+  #include <WebServer.h>
+  typedef WebServer ESP8266WebServer;
+  //-- WiFi, the webserver, the fetches and the producer side of queueStuff
+  //-- run in a task on NET_TASK_CORE, loop() (core 1) drives the display
+  #define NET_TASK_CORE       0
+  #define NET_TASK_STACK   8192
+  #define NET_TASK_PRIO       1
+#endif
+
 #define _HOSTNAME   "ESPticker"
 
 #define MAX_FILES_IN_LIST   25
+#define LIST_NAME_MAX       40    // path and name, without the leading '/'
+#define LIST_MAX_DEPTH       3
+#define MAX_WEB_ASSETS      10
+#define UPLOAD_TEMP         "/upload.tmp"
+#define UPLOAD_BUF_SIZE     512   // two LittleFS pages, written at once
+#define UPLOAD_SPARE      16384   // kept free next to an upload (two blocks)
 
 #endif // ALLDEFINES_H
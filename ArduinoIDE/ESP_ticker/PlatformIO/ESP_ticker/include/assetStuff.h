@@ -0,0 +1,25 @@
+#ifndef ASSETSTUFF_H
+#define ASSETSTUFF_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+//== Local Headers ==
+#include "helperStuff.h"
+#include "FSexplorer.h"
+#include "allDefines.h"
+
+//== Extern Variables ==
+extern ESP8266WebServer httpServer;
+
+//== Type Definitions ==
+#define ASSET_ETAG_SIZE   11    // '"' + 8 hex digits + '"' + '\0'
+
+//== Function Prototypes ==
+void setupAssets();
+void serveAsset(const char *uri, const char *path);
+void assetChanged(const char *path);
+bool assetNotModified(const char *eTag);
+
+
+#endif // ASSETSTUFF_H
@@ -0,0 +1,72 @@
+#ifndef FETCHSTUFF_H
+#define FETCHSTUFF_H
+
+#include <Arduino.h>
+#if defined(ESP32)
+  #include <WiFi.h>
+  #include <WiFiClientSecure.h>
+#else
+  #include <ESP8266WiFi.h>
+  #include <WiFiClientSecureBearSSL.h>
+#endif
+#include <LittleFS.h>
+
+//== Local Headers ==
+#include "helperStuff.h"
+#include "metricsStuff.h"
+#include "allDefines.h"
+
+//== Type Definitions ==
+#define FETCH_WEERLIVE    0
+#define FETCH_NEWSAPI     1
+#define FETCH_PROVIDERS   2
+
+#define FETCH_IDLE        0
+#define FETCH_CONNECT     1       // reuse a connection or resolve the host
+#define FETCH_HANDSHAKE   2       // (TLS) connect, a pass of loop() of its own
+#define FETCH_SEND        3
+#define FETCH_HEADERS     4
+#define FETCH_BODY        5
+
+#define FETCH_HTTPS_PORT  443     // fetchStart() with this port uses TLS
+#define FETCH_HOSTS       FETCH_PROVIDERS
+
+//-- return false when no more data is needed
+typedef bool (*fetchBodyHandler)(const char *data, int len);
+typedef void (*fetchDoneHandler)(bool ok);
+
+typedef struct _fetchStats {
+  int16_t   httpStatus;     // 0 = no connection/response
+  uint32_t  startTime;
+  uint32_t  duration;       // ms, last completed fetch
+  uint32_t  bodyBytes;
+  uint16_t  okCount;
+  uint16_t  failCount;
+} fetchStats;
+
+//-- per upstream host: DNS cache entry and connection statistics
+typedef struct _fetchHostStats {
+  const char *name;           // NULL = free entry
+  IPAddress   ip;
+  uint32_t    resolvedAt;     // millis(), 0 = resolve again
+  uint32_t    dnsMs;          // last lookup
+  uint32_t    connectMs;      // last (TLS) connect, the part that blocks
+  uint32_t    maxConnectMs;
+  uint16_t    connects;
+  uint16_t    reuses;         // fetches over a kept-alive connection
+  uint16_t    connectFails;
+  uint8_t     mfln;           // 0 = not known yet, 1 = supported, 2 = refused
+  uint16_t    certFails;      // TLS connects that failed (certificate, clock)
+} fetchHostStats;
+
+//== Function Prototypes ==
+bool fetchStart(uint8_t provider, const char *host, uint16_t port, const char *path
+                                , fetchBodyHandler onBody, fetchDoneHandler onDone);
+void fetchLoop();
+bool fetchBusy();
+const fetchStats *fetchGetStats(uint8_t provider);
+const char *fetchProviderName(uint8_t provider);
+const fetchHostStats *fetchGetHost(uint8_t h);
+
+
+#endif // FETCHSTUFF_H
@@ -29,9 +29,9 @@ int strIndex(const char *haystack, const char *needle);
 int stricmp(const char *a, const char *b);
 float formatFloat(float v, int dec);
 float strToFloat(const char *s, int dec);
-void parseJsonKey(const char *sIn, const char *key, char *val, int valLen);
-uint8_t utf8Ascii(uint8_t ascii);
-void utf8Ascii(char* s);
+uint16_t latin1ToUnicode(uint8_t c);
+int utf8ToLatin1(char *s);
+uint32_t calcCRC32(const void *data, size_t len, uint32_t crc = 0);
 void getRevisionData();
 
 
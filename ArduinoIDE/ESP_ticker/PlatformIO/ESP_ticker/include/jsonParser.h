@@ -0,0 +1,45 @@
+#ifndef JSONPARSER_H
+#define JSONPARSER_H
+
+#include <Arduino.h>
+
+//== Local Headers ==
+#include "allDefines.h"
+
+//== Type Definitions ==
+#define JSON_KEY_MAX        25
+
+#define JSON_EV_VALUE        1    // key[] holds the key, val[] the (decoded) value
+#define JSON_EV_OBJECT_START 2
+#define JSON_EV_OBJECT_END   3
+
+struct _jsonScanner;
+//-- return false to stop scanning
+typedef bool (*jsonEventHandler)(struct _jsonScanner *js, uint8_t event);
+
+typedef struct _jsonScanner {
+  uint8_t           state;
+  uint8_t           depth;
+  uint32_t          objStack;     // bit n set: level n is an object
+  bool              expectKey;
+  bool              inKey;
+  bool              isString;     // last value was a "string"
+  bool              truncated;    // last value did not fit in val[]
+  bool              stopped;
+  char              key[JSON_KEY_MAX];
+  uint8_t           keyLen;
+  char             *val;
+  uint16_t          valMax;
+  uint16_t          valLen;
+  uint16_t          uniCode;
+  uint8_t           uniDigits;
+  uint16_t          hiSurrogate;
+  jsonEventHandler  onEvent;
+} jsonScanner;
+
+//== Function Prototypes ==
+void jsonScanBegin(jsonScanner *js, char *valBuff, uint16_t valMax, jsonEventHandler onEvent);
+bool jsonScanFeed(jsonScanner *js, const char *data, int len);
+
+
+#endif // JSONPARSER_H
@@ -4,24 +4,36 @@
 #include <Arduino.h>
 
 //== Local Headers ==
+#include "helperStuff.h"
 #include "allDefines.h"
 
 //== Extern Variables ==
 extern ESP8266WebServer httpServer;
 
 
+//== Type Definitions ==
+typedef void (*jsonSink)(const char *data, uint16_t len);
+
 //== Function Prototypes ==
-void sendStartJsonObj(const char *objName);
+void sendStartJsonObj(const char *objName, int httpCode = 200);
 void sendEndJsonObj();
+void sendStartJsonList();
+void sendJsonListObjStart();
+void sendJsonListField(const char *cKey, const char *cValue);
+void sendJsonListObjEnd();
+void sendEndJsonList();
 void sendNestedJsonObj(const char *cName, const char *cValue);
-void sendNestedJsonObj(const char *cName, String sValue);
+void sendNestedJsonObj(const char *cName, const String &sValue);
 void sendNestedJsonObj(const char *cName, int32_t iValue);
 void sendNestedJsonObj(const char *cName, uint32_t uValue);
 void sendNestedJsonObj(const char *cName, float fValue);
+void sendNestedJsonArray(const char *cName, const uint32_t *values, uint8_t count);
 void sendJsonSettingObj(const char *cName, float fValue, const char *fType, int minValue, int maxValue);
 void sendJsonSettingObj(const char *cName, float fValue, const char *fType, int minValue, int maxValue, int decPlaces);
 void sendJsonSettingObj(const char *cName, int iValue, const char *iType, int minValue, int maxValue);
 void sendJsonSettingObj(const char *cName, const char *cValue, const char *sType, int maxLen);
+void sendJsonMessageObj(const char *cName, const char *cValue, int maxLen);
+void sendJsonEvent(jsonSink sink, const char *type, const char *cName, const char *cValue, bool isLatin1);
 
 
 #endif // JSONSTUFF_H
@@ -2,22 +2,37 @@
 #define LITTLEFSSTUFF_H
 
 #include <Arduino.h>
+#include <LittleFS.h>
 
 //== Local Headers ==
+#include "metricsStuff.h"
 #include "allDefines.h"
 
 //== Extern Variables ==
 extern uint32_t nrReboots;
 extern uint8_t settingLocalMaxMsg;
+extern char fileMessage[];
 
 
 //== Function Prototypes ==
 void readLastStatus();
 void writeLastStatus();
+void readLastWeather(char *dest, int maxLen);
+void writeLastWeather(const char *weather);
+void loadMessageCache();
+void beginMessageBatch();
+void commitMessageBatch();
+bool hasMessage(const char* fType, uint8_t mId);
 bool readFileById(const char* fType, uint8_t mId);
 bool writeFileById(const char* fType, uint8_t mId, const char *msg);
+uint32_t messageSlots(const char* fType);
+int8_t nextChangedMessage();
+uint32_t urgentMessages();
+uint32_t messageExpires(uint8_t mId);
+bool setMessageOptions(uint8_t mId, bool urgent, uint32_t expires);
+void expireMessages(uint32_t nowSec);
+const char *checkMessage(const char *field, const char *newValue);
 void updateMessage(const char *field, const char *newValue);
-void writeToLog(const char *logLine);
 
 
 #endif // LITTLEFSSTUFF_H
@@ -0,0 +1,45 @@
+#ifndef LOGSTUFF_H
+#define LOGSTUFF_H
+
+#include <Arduino.h>
+#include <Print.h>
+
+//== Type Definitions ==
+#define LOG_LEVEL_NONE    0
+#define LOG_LEVEL_ERROR   1
+#define LOG_LEVEL_INFO    2
+#define LOG_LEVEL_DEBUG   3
+
+//-- set from platformio.ini (-DLOG_LEVEL=n), a module can use a different
+//-- level with '#define LOG_MODULE_LEVEL n' before its first #include
+#ifndef LOG_LEVEL
+  #define LOG_LEVEL       LOG_LEVEL_DEBUG
+#endif
+#ifndef LOG_MODULE_LEVEL
+  #define LOG_MODULE_LEVEL  LOG_LEVEL
+#endif
+
+#define LOG_RING_SIZE     2048    // must be a power of 2
+#define LOG_DRAIN_MAX      128    // max bytes per logDrain() call
+
+//-- everything written to DebugLog goes into a RAM ring buffer that
+//-- logDrain() empties to Serial (and telnet) without blocking loop()
+class logStream : public Print {
+  public:
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+};
+
+//== Extern Variables ==
+extern logStream DebugLog;
+
+//== Function Prototypes ==
+void startTelnet();
+void logSetBlocking(bool blocking);
+void logDrain();
+void logFlush();
+uint32_t logLost();
+void sendLogBuffer();
+
+
+#endif // LOGSTUFF_H
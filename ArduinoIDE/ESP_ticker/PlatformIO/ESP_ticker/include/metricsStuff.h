@@ -0,0 +1,39 @@
+#ifndef METRICSSTUFF_H
+#define METRICSSTUFF_H
+
+#include <Arduino.h>
+
+//== Local Headers ==
+#include "jsonStuff.h"
+#include "fetchStuff.h"
+#include "sysLogStuff.h"
+#include "pushStuff.h"
+#include "allDefines.h"
+
+//== Extern Variables ==
+extern uint8_t  bootStatus;
+extern uint32_t firstScrollMs;
+
+//== Type Definitions ==
+//-- log2 histogram: bucket 0 < 64, bucket 1 < 128 .. last bucket open ended
+#define METRIC_BUCKETS        12
+#define METRIC_FIRST_SHIFT     6
+
+typedef struct _metricHisto {
+  uint32_t  bucket[METRIC_BUCKETS];
+  uint32_t  count;
+  uint32_t  max;
+  uint64_t  sum;
+} metricHisto;
+
+//== Function Prototypes ==
+void metricsLoopStart();
+void metricsFrameStart();
+void metricsMessageGap(uint32_t startMicros);
+void metricsFetchDone(uint8_t provider, uint32_t durationMs, bool ok);
+void metricsFsOp(bool isWrite, uint32_t startMicros);
+void metricsReset();
+void sendMetrics();
+
+
+#endif // METRICSSTUFF_H
@@ -30,26 +30,33 @@
 */
 
 #include "allDefines.h"
+#include "sysLogStuff.h"
 
-#include <ESP8266WiFi.h>        //ESP8266 Core WiFi Library         
-#include <ESP8266WebServer.h>   // Version 1.0.0 - part of ESP8266 Core https://github.com/esp8266/Arduino
-#include <ESP8266mDNS.h>        // part of ESP8266 Core https://github.com/esp8266/Arduino
+#include "platformStuff.h"     // WiFi, webserver and mDNS of the ESP8266 or ESP32 core
 
 #include <WiFiUdp.h>            // part of ESP8266 Core https://github.com/esp8266/Arduino
 #ifdef USE_UPDATE_SERVER
+  #if defined(ESP32)
+    #include <HTTPUpdateServer.h> // part of the ESP32 Core https://github.com/espressif/arduino-esp32
+    #include <Update.h>
+  #else
 //#include "ESP8266HTTPUpdateServer.h"
-  #include <ModUpdateServer.h>   // https://github.com/mrWheel/ModUpdateServer
-  #include "updateServerHtml.h"
+    #include <ModUpdateServer.h>   // https://github.com/mrWheel/ModUpdateServer
+    #include "updateServerHtml.h"
+  #endif
 #endif
 #include <WiFiManager.h>       // version 0.15.0 - https://github.com/tzapu/WiFiManager
 //#include <FS.h>                // part of ESP8266 Core https://github.com/esp8266/Arduino
 
 
 ESP8266WebServer        httpServer (80);
+#if defined(ESP32)
+HTTPUpdateServer        httpUpdater(true);
+#else
 ESP8266HTTPUpdateServer httpUpdater(true);
+#endif
 
 
-static      FSInfo LittleFSinfo;
 bool        LittleFSmounted; 
 bool        isConnected = false;
 
@@ -58,6 +65,8 @@ bool        isConnected = false;
 void configModeCallback (WiFiManager *myWiFiManager) 
 {
   DebugTln(F("Entered config mode\r"));
+  //-- the portal blocks for minutes and WiFiManager may reset the ESP
+  sysLogBeforeReboot("WiFi config portal");
   DebugTln(WiFi.softAPIP().toString());
   //if you used auto generated SSID, print it
   DebugTln(myWiFiManager->getConfigPortalSSID());
@@ -106,12 +115,38 @@ void startWiFi(const char* hostname, int timeOut)
   DebugT(F("IP gateway: " ));  Debugln (WiFi.gatewayIP());
   Debugln();
 
+  DebugTf(" took [%d] seconds => OK!\r\n", (millis() - lTime) / 1000);
+  
+} // startWiFi()
+
+
+//=======================================================================
+void startUpdateServer() 
+{
   httpUpdater.setup(&httpServer);
+  //-- the update server restarts the ESP itself after a new firmware
+#if defined(ESP32)
+  //-- the ESP32 webserver has no hooks, the first piece written will do
+  Update.onProgress([](size_t done, size_t total)
+  {
+    static bool logged = false;
+    (void)done; (void)total;
+    if (!logged) sysLogBeforeReboot("firmware update");
+    logged = true;
+  });
+#else
+  httpServer.addHook([](const String& method, const String& url, WiFiClient* client
+                                            , ESP8266WebServer::ContentTypeFunction contentType)
+  {
+    (void)client; (void)contentType;
+    if (method == "POST" && url.startsWith("/update")) sysLogBeforeReboot("firmware update");
+    return ESP8266WebServer::CLIENT_REQUEST_CAN_CONTINUE;
+  });
   httpUpdater.setIndexPage(UpdateServerIndex);
   httpUpdater.setSuccessPage(UpdateServerSuccess);
-  DebugTf(" took [%d] seconds => OK!\r\n", (millis() - lTime) / 1000);
+#endif
   
-} // startWiFi()
+} // startUpdateServer()
 
 
 //=======================================================================
@@ -4,12 +4,17 @@
 #include <Arduino.h>
 
 //== Local Headers ==
-#include "ESP_ticker.h"
 #include "littlefsStuff.h"
 #include "helperStuff.h"
+#include "jsonParser.h"
+#include "fetchStuff.h"
+#include "schedStuff.h"
+#include "noWordStuff.h"
 #include "allDefines.h"
 
 //== Extern Variables ==
+extern char tempMessage[];
+extern char settingNewsAUTH[];
 extern uint8_t settingNewsMaxMsg;
 
 
@@ -0,0 +1,17 @@
+#ifndef NOWORDSTUFF_H
+#define NOWORDSTUFF_H
+
+#include <Arduino.h>
+
+//== Local Headers ==
+#include "allDefines.h"
+
+//== Extern Variables ==
+
+
+//== Function Prototypes ==
+void splitNewsNoWords(const char *noNo);
+bool hasNoNoWord(const char *cIn);
+
+
+#endif // NOWORDSTUFF_H
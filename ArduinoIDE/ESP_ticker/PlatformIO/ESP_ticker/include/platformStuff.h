@@ -0,0 +1,49 @@
+#ifndef PLATFORMSTUFF_H
+#define PLATFORMSTUFF_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#if defined(ESP32)
+  #include <WiFi.h>
+  #include <WebServer.h>
+  #include <ESPmDNS.h>
+#else
+  #include <ESP8266WiFi.h>
+  #include <ESP8266WebServer.h>
+  #include <ESP8266mDNS.h>
+#endif
+
+//== Local Headers ==
+#include "allDefines.h"
+
+//== Type Definitions ==
+//-- the entries of a directory: Dir on the ESP8266, File on the ESP32
+class fsDir {
+  public:
+    fsDir(const char *path);
+    bool      next();
+    String    fileName();       // without the path
+    uint32_t  fileSize();
+    bool      isDirectory();
+  private:
+#if defined(ESP32)
+    File      dir;
+    File      entry;
+#else
+    Dir       dir;
+#endif
+};
+
+//== Function Prototypes ==
+uint32_t platformChipId();
+uint32_t platformMaxFreeBlock();
+void platformHeapStats(uint32_t *hFree, uint32_t *hBlock, uint8_t *hFrag);
+String platformResetReason();
+uint32_t platformFsTotal();
+uint32_t platformFsUsed();
+void platformSetHostname(const char *hostname);
+void platformMdnsHostname(const char *hostname);
+void platformMdnsLoop();
+
+
+#endif // PLATFORMSTUFF_H
@@ -0,0 +1,26 @@
+#ifndef PLAYLISTSTUFF_H
+#define PLAYLISTSTUFF_H
+
+#include <Arduino.h>
+
+//== Local Headers ==
+#include "helperStuff.h"
+#include "allDefines.h"
+
+//== Extern Variables ==
+extern uint8_t settingPlayWeight[];
+
+
+//== Function Prototypes ==
+void playlistBuild();
+uint8_t playlistNext(bool haveUrgent);
+void playlistInterrupt();
+bool playlistInterrupted();
+uint8_t playlistLength();
+uint8_t playlistEntry(uint8_t pos);
+const char *playlistSourceName(uint8_t src);
+int8_t playlistSource(const char *name);
+int8_t nextMessageSlot(uint32_t slots, int8_t after);
+
+
+#endif // PLAYLISTSTUFF_H
@@ -0,0 +1,23 @@
+#ifndef PUSHSTUFF_H
+#define PUSHSTUFF_H
+
+#include <Arduino.h>
+
+//== Local Headers ==
+#include "allDefines.h"
+
+//== Extern Variables ==
+extern char *actMessage;
+extern uint8_t settingLocalMaxMsg;
+extern char fileMessage[];
+
+
+//== Function Prototypes ==
+void pushSubscribe();
+void pushLoop();
+void pushDisplayed();
+uint8_t pushViewers();
+uint32_t pushDropped();
+
+
+#endif // PUSHSTUFF_H
@@ -0,0 +1,30 @@
+#ifndef QUEUESTUFF_H
+#define QUEUESTUFF_H
+
+#include <Arduino.h>
+
+//== Local Headers ==
+#include "allDefines.h"
+
+//== Type Definitions ==
+typedef struct _queuedMsg {
+  uint8_t   kind;           // how it is shown (NEXT_xx in ESP_ticker.cpp)
+  uint8_t   source;         // PLAY_xx
+  uint8_t   fxIn, fxOut;    // index in effect[]
+  bool      cutIn;          // cuts short the news on the display
+  bool      dropped;        // see queueDrop()
+  char      text[NEWS_SIZE];
+} queuedMsg;
+
+//== Function Prototypes ==
+queuedMsg *queueWrite();
+void queuePublish();
+queuedMsg *queueRead(uint8_t n);
+void queueRelease();
+uint8_t queueCount();
+queuedMsg *queueNewest();
+void queueDrop(queuedMsg *msg);
+bool queueDropped(queuedMsg *msg);
+
+
+#endif // QUEUESTUFF_H
@@ -2,12 +2,20 @@
 #define RESTAPI_H
 
 #include <Arduino.h>
+#include "platformStuff.h"
 
 //== Local Headers ==
+#include "ESP_ticker.h"
 #include "settingStuff.h"
 #include "littlefsStuff.h"
 #include "jsonStuff.h"
+#include "jsonParser.h"
 #include "helperStuff.h"
+#include "fetchStuff.h"
+#include "metricsStuff.h"
+#include "sysLogStuff.h"
+#include "playlistStuff.h"
+#include "pushStuff.h"
 #include "allDefines.h"
 
 //== Extern Variables ==
@@ -16,13 +24,36 @@ extern String lastReset;
 extern bool Verbose;
 extern uint16_t settingLDRhighOffset;
 extern uint16_t settingLDRlowOffset;
+extern uint16_t settingLDRsampleTime;
+extern uint8_t settingLDRsmoothing;
 extern uint8_t settingLocalMaxMsg;
 extern uint8_t settingMaxIntensity;
 extern uint8_t settingNewsInterval;
 extern uint8_t settingNewsMaxMsg;
 extern uint8_t settingTextSpeed;
 extern uint8_t settingWeerLiveInterval;
+extern uint8_t settingPlayWeight[];
+extern uint8_t settingDisplayModules;
+extern uint8_t settingClockModules;
 
+//== Type Definitions ==
+#define API_URI_MAX     80
+#define API_MAX_WORDS    6    // 'api', 'v0', route and up to 3 parameters
+
+typedef void (*apiHandler)(uint8_t argc, char *argv[]);
+
+typedef struct _apiRoute {
+  HTTPMethod  method;     // HTTP_GET or HTTP_PUT (also for POST)
+  uint32_t    pathHash;   // apiHash(path)
+  const char *path;
+  apiHandler  handler;
+} apiRoute;
+
+//-- FNV-1a, constexpr so the route table hashes are compile time constants
+constexpr uint32_t apiHash(const char *s, uint32_t h = 2166136261u)
+{
+  return (*s == '\0') ? h : apiHash(s +1, (h ^ (uint8_t)*s) * 16777619u);
+}
 
 //== Function Prototypes ==
 void processAPI();
@@ -33,6 +64,8 @@ void sendLocalMessages();
 void sendNewsMessages();
 void postMessages();
 void postSettings();
+void sendPlaylist();
+void postPlaylist();
 void sendApiNotFound(const char *URI);
 
 
@@ -0,0 +1,18 @@
+#ifndef SCHEDSTUFF_H
+#define SCHEDSTUFF_H
+
+#include <Arduino.h>
+
+//== Local Headers ==
+#include "allDefines.h"
+
+//== Function Prototypes ==
+void schedBegin(uint32_t seed);
+bool schedDue(uint8_t task);
+void schedRun(uint8_t task, uint32_t periodMs);
+void schedDone(uint8_t task, bool ok);
+uint8_t schedFails(uint8_t task);
+uint32_t schedIdleMs();
+
+
+#endif // SCHEDSTUFF_H
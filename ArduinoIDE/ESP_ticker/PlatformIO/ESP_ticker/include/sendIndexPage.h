@@ -4,6 +4,7 @@
 #include <Arduino.h>
 
 //== Local Headers ==
+#include "assetStuff.h"
 #include "allDefines.h"
 
 //== Extern Variables ==
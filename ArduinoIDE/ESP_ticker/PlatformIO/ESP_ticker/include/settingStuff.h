@@ -4,14 +4,30 @@
 #include <Arduino.h>
 
 //== Local Headers ==
-#include "ESP_ticker.h"
+#include "platformStuff.h"
+#include "littlefsStuff.h"
 #include "newsapi_org.h"
+#include "noWordStuff.h"
 #include "helperStuff.h"
+#include "metricsStuff.h"
+#include "playlistStuff.h"
 #include "allDefines.h"
 
 //== Extern Variables ==
+extern char tempMessage[LOCAL_SIZE];
+//-- with their size, settingFields[] keeps whole buffers
+extern char settingHostname[41];
+extern char settingNewsNoWords[LOCAL_SIZE];
+extern char settingWeerLiveAUTH[51];
+extern char settingWeerLiveLocation[51];
+extern char settingNewsAUTH[51];
+extern uint8_t settingPlayWeight[PLAY_SOURCES];
+extern uint8_t settingDisplayModules;
+extern uint8_t settingClockModules;
 extern uint16_t settingLDRhighOffset;
 extern uint16_t settingLDRlowOffset;
+extern uint16_t settingLDRsampleTime;
+extern uint8_t settingLDRsmoothing;
 extern uint8_t settingLocalMaxMsg;
 extern uint8_t settingMaxIntensity;
 extern uint8_t settingNewsInterval;
@@ -23,7 +39,14 @@ extern uint8_t settingWeerLiveInterval;
 //== Function Prototypes ==
 void writeSettings(bool show);
 void readSettings(bool show);
+void settingsExport();
+void settingsIniChanged();
+void settingsLoop();
+const char *checkSetting(const char *field, const char *newValue);
+void beginSettingsBatch();
+void commitSettingsBatch();
 void updateSetting(const char *field, const char *newValue);
+bool nextChangedSetting(const char **name, char *value, int maxLen);
 
 
 #endif // SETTINGSTUFF_H
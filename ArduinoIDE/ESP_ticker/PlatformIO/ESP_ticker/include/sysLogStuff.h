@@ -0,0 +1,22 @@
+#ifndef SYSLOGSTUFF_H
+#define SYSLOGSTUFF_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+//== Local Headers ==
+#include "metricsStuff.h"
+#include "allDefines.h"
+
+//== Function Prototypes ==
+void sysLogBegin();
+void sysLogLoop();
+void sysLogFlush();
+void sysLogBeforeReboot(const char *reason);
+void rebootDevice(const char *reason);
+uint32_t sysLogLost();
+void writeToLog(const char *logLine);
+void sendSysLog();
+
+
+#endif // SYSLOGSTUFF_H
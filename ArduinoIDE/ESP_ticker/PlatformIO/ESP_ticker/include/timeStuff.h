@@ -21,6 +21,10 @@ int8_t DayFromTimestamp(const char *timeStamp);
 int8_t MonthFromTimestamp(const char *timeStamp);
 int8_t YearFromTimestamp(const char *timeStamp);
 int32_t HoursKeyTimestamp(const char *timeStamp);
+void timeSnapshot();
+int8_t clockHour();
+int8_t clockMinute();
+int8_t clockSecond();
 
 
 #endif // TIMESTUFF_H
@@ -5,8 +5,29 @@
 
 //== Local Headers ==
 #include "helperStuff.h"
+#include "jsonParser.h"
+#include "fetchStuff.h"
+#include "schedStuff.h"
+#include "littlefsStuff.h"
 #include "allDefines.h"
 
+//== Type Definitions ==
+#define WEATHER_VALUE_SIZE  51
+
+//-- only the fields that are shown, as the strings weerlive sends them
+typedef struct _weatherData {
+  char      plaats[WEATHER_VALUE_SIZE];
+  char      samenv[WEATHER_VALUE_SIZE];
+  char      luchtd[8];
+  char      d0tmin[6];
+  char      d0tmax[6];
+  char      d1weer[WEATHER_VALUE_SIZE];
+  char      d1tmin[6];
+  char      d1tmax[6];
+  char      fout[WEATHER_VALUE_SIZE];   // error from the api (bad key ..)
+  uint16_t  found;                      // bit n: weatherFields[n] is in
+} WeatherData;
+
 //== Extern Variables ==
 
 //== Function Prototypes ==
@@ -0,0 +1,154 @@
+#
+#  ramBudget.py - PlatformIO (post) extra_script for ESP_ticker
+#
+#  After the link it writes '$BUILD_DIR/ramBudget.txt': the RAM (.data,
+#  .rodata, .bss), IRAM and flash use per source file (from the linker
+#  map) and per symbol (from nm). The lines are sorted by name, so two
+#  reports can be diffed; the one of the previous build is kept as
+#  'ramBudget.prev.txt'. The build fails when .data + .rodata + .bss is
+#  more than 'custom_ram_budget' (bytes, 0 = no check) of the env.
+#
+#  Copyright (c) 2023 Willem Aandewiel
+#
+#  TERMS OF USE: MIT License.
+#
+import os
+import re
+import subprocess
+
+Import("env")
+
+REPORT_NAME = "ramBudget.txt"
+SYMBOL_MIN  = 16          # smaller symbols are only in the totals
+
+#-- ESP8266 memory map
+REGIONS = [
+  ("dram",  0x3FFE8000, 0x40000000),    # .data .rodata .bss (and the heap)
+  ("iram",  0x40100000, 0x40110000),    # .text, IRAM_ATTR code
+  ("flash", 0x40200000, 0x40400000),    # .irom0.text, PROGMEM
+]
+
+MAP_FILE = os.path.join(env.subst("$BUILD_DIR"), "firmware.map")
+env.Append(LINKFLAGS=["-Wl,-Map," + MAP_FILE])
+
+
+def region_of(addr):
+  for name, start, end in REGIONS:
+    if start <= addr < end:
+      return name
+  return None
+
+
+def file_label(path):
+  #-- 'libmain.a(user_interface.o)' -> 'libmain.a', 'src/ESP_ticker.cpp.o' -> 'ESP_ticker.cpp'
+  path = path.replace("\\", "/")
+  if "(" in path:
+    return os.path.basename(path.split("(")[0])
+  name = os.path.basename(path)
+  return name[:-2] if name.endswith(".o") else name
+
+
+def read_map(map_file):
+  """{file: {region: bytes}} from the input sections in the map"""
+  per_file = {}
+  line_re  = re.compile(r"^\s+(\.\S+)?\s*0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+  in_map   = False    # the part before it lists discarded and archive members
+  with open(map_file, "r", errors="replace") as f:
+    for line in f:
+      if line.startswith("Linker script and memory map"):
+        in_map = True
+        continue
+      if not in_map:
+        continue
+      #-- a long section name is on a line of its own, the line after it
+      #-- has the address, size and file and matches without the name
+      m = line_re.match(line.rstrip("\n"))
+      if not m or m.group(4).startswith("load address"):
+        continue
+      addr, size = int(m.group(2), 16), int(m.group(3), 16)
+      region = region_of(addr)
+      if size == 0 or region is None:
+        continue
+      label = file_label(m.group(4).strip())
+      per_file.setdefault(label, {}).setdefault(region, 0)
+      per_file[label][region] += size
+  return per_file
+
+
+def read_symbols(nm, elf):
+  """[(region, name, type, bytes)] from nm"""
+  out = subprocess.run([nm, "-S", "-C", "--defined-only", elf], capture_output=True
+                                                    , text=True, env=env["ENV"]).stdout
+  symbols = []
+  for line in out.splitlines():
+    parts = line.split(None, 3)
+    if len(parts) < 4:
+      continue
+    addr, size, kind, name = int(parts[0], 16), int(parts[1], 16), parts[2], parts[3]
+    region = region_of(addr)
+    if region is None or size < SYMBOL_MIN:
+      continue
+    symbols.append((region, name, kind, size))
+  return symbols
+
+
+def section_totals(size_tool, elf):
+  """{section: bytes} from 'size -A'"""
+  out = subprocess.run([size_tool, "-A", elf], capture_output=True, text=True, env=env["ENV"]).stdout
+  totals = {}
+  for line in out.splitlines():
+    parts = line.split()
+    if len(parts) >= 2 and parts[0].startswith(".") and parts[1].isdigit():
+      totals[parts[0]] = int(parts[1])
+  return totals
+
+
+def ram_budget_report(target, source, env):
+  elf       = str(target[0])
+  build_dir = env.subst("$BUILD_DIR")
+  report    = os.path.join(build_dir, REPORT_NAME)
+  previous  = os.path.join(build_dir, "ramBudget.prev.txt")
+  nm        = env.subst("$CC").replace("gcc", "nm")
+  size_tool = env.subst("$SIZETOOL") or env.subst("$CC").replace("gcc", "size")
+  budget    = int(env.GetProjectOption("custom_ram_budget", "0"))
+
+  sections = section_totals(size_tool, elf)
+  ram      = sum(sections.get(s, 0) for s in (".data", ".rodata", ".bss"))
+  iram     = sum(sections.get(s, 0) for s in (".text", ".iram0.text", ".text1"))
+  flash    = sum(sections.get(s, 0) for s in (".irom0.text", ".irom.text"))
+
+  lines = []
+  lines.append("# ramBudget for %s" % env.subst("$PIOENV"))
+  lines.append("ram    %7d  (.data %d .rodata %d .bss %d)" % (ram, sections.get(".data", 0)
+                                            , sections.get(".rodata", 0), sections.get(".bss", 0)))
+  lines.append("iram   %7d" % iram)
+  lines.append("flash  %7d" % flash)
+  lines.append("budget %7d" % budget)
+  lines.append("")
+  lines.append("# per file: dram iram flash")
+  if os.path.isfile(MAP_FILE):
+    per_file = read_map(MAP_FILE)
+    for label in sorted(per_file):
+      use = per_file[label]
+      lines.append("%-40s %7d %7d %7d" % (label, use.get("dram", 0), use.get("iram", 0), use.get("flash", 0)))
+  lines.append("")
+  lines.append("# per symbol (>= %d bytes): region type bytes" % SYMBOL_MIN)
+  symbols = read_symbols(nm, elf)
+  for region, name, kind, size in sorted(symbols):
+    lines.append("%-5s %s %7d  %s" % (region, kind, size, name))
+
+  if os.path.isfile(report):
+    os.replace(report, previous)
+  with open(report, "w") as f:
+    f.write("\n".join(lines) + "\n")
+
+  print("ramBudget: ram [%d] iram [%d] flash [%d] bytes, report in %s" % (ram, iram, flash, report))
+  for region, name, kind, size in sorted([s for s in symbols if s[0] == "dram"], key=lambda s: -s[3])[:10]:
+    print("ramBudget:   %7d  %s" % (size, name))
+  if budget > 0 and ram > budget:
+    print("ramBudget: ERROR ram [%d] is [%d] bytes over the budget of [%d]" % (ram, ram - budget, budget))
+    return 1
+  return 0
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", ram_budget_report)
@@ -44,6 +44,12 @@
 // CS or LD   D8     HSPICS or HCS
 // CLK        D5     CLK or HCLK
 //
+// and for the ESP32 ([env:esp32]) VSPI:
+// DIN       GPIO23  VSPI MOSI
+// CS or LD  GPIO5   VSPI SS
+// CLK       GPIO18  VSPI CLK
+// LDR       GPIO36  A0
+//
 // MD_MAX72XX library can be found at https://github.com/MajicDesigns/MD_MAX72XX
 //
 
@@ -55,6 +61,10 @@
 // HARDWARE SPI
 MD_Parola P = MD_Parola(HARDWARE_TYPE, CS_PIN, MAX_DEVICES);
 
+static bool     clockZone  = false;     // ZONE_CLOCK is in use
+static char     clockMsg[8];
+static char     portalMsg[80] = "";     // while the WiFiManager portal is up
+
 // WiFi Server object and parameters
 WiFiServer server(80);
 
@@ -91,27 +101,51 @@ textEffect_t  effect[] =
 
 
 //---------------------------------------------------------------------
+//-- called from loop(): reads A0 once every settingLDRsampleTime ms
+//-- and keeps an exponential moving average of it in valueLDR
+void sampleLDR()
+{
+  static uint32_t ldrTimer = 0;
+  static int32_t  ldrAvg   = -1;    // valueLDR * 16
+
+  if ((ldrAvg >= 0) && ((millis() - ldrTimer) < settingLDRsampleTime)) return;
+  ldrTimer = millis();
+
+  int32_t a0In = analogRead(A0) * 16;
+  if (ldrAvg < 0)                     ldrAvg  = a0In;   // first sample
+  else if (settingLDRsmoothing > 1)   ldrAvg += (a0In - ldrAvg) / settingLDRsmoothing;
+  else                                ldrAvg  = a0In;
+  valueLDR = ldrAvg / 16;
+  
+} // sampleLDR()
+
+
+//---------------------------------------------------------------------
+//-- no reading here, sampleLDR() keeps valueLDR up-to-date
 int16_t calculateIntensity()
 {
-  int a0In = 0;
-  for (int l=0; l<2; l++)
+  static int16_t  ldrAtChange = -1;
+  static int16_t  intensity   =  0;
+  static uint8_t  maxAtChange =  0;
+  int16_t         ldr = valueLDR;
+  
+  if (ldr < settingLDRlowOffset)   ldr = settingLDRlowOffset;
+  if (ldr > settingLDRhighOffset)  ldr = settingLDRhighOffset;
+
+  //--- hysteresis: small changes of the LDR do not change the intensity
+  if ((ldrAtChange >= 0) && (abs(ldr - ldrAtChange) <= LDR_HYSTERESIS)
+                         && (maxAtChange == settingMaxIntensity))
   {
-    //--- read analog A0
-    a0In+= analogRead(A0);
-    delay(200);
+    return intensity;
   }
-  a0In = a0In / 2;  //-- smooth things up a bit
+  ldrAtChange = ldr;
+  maxAtChange = settingMaxIntensity;
   
-  DebugTf("analogRead[%d], ", a0In);
-  //---test if (a0In < settingLDRlowOffset) a0In = settingLDRlowOffset;
-  Debugf(" LDRlowOffset[%d] LDRhighOffset[%d] ", settingLDRlowOffset, settingLDRhighOffset);
-  valueLDR = (valueLDR + a0In) / 2;
-  if (valueLDR < settingLDRlowOffset)   valueLDR = settingLDRlowOffset;
-  if (valueLDR > settingLDRhighOffset)  valueLDR = settingLDRhighOffset;
-  Debugf(" ==> valueLDR[%d]\r\n", valueLDR);
+  DebugTf("valueLDR[%d] LDRlowOffset[%d] LDRhighOffset[%d] ", valueLDR, settingLDRlowOffset, settingLDRhighOffset);
+  Debugf(" ==> LDR[%d]\r\n", ldr);
 
   //--- map LDR to offset..1024 -> 0..settingMax
-  int intensity = map(valueLDR, settingLDRlowOffset, settingLDRhighOffset,  0, settingMaxIntensity);
+  intensity = map(ldr, settingLDRlowOffset, settingLDRhighOffset,  0, settingMaxIntensity);
   //DebugTf("map(%d, %d, %d, 0, %d) => [%d]\r\n", valueLDR, settingLDRlowOffset, settingLDRhighOffset
   //                                                      , 0                  , settingMaxIntensity);
 
@@ -132,121 +166,536 @@ int16_t calculateIntensity()
 } // calculateIntensity()
 
 
+//---------------------------------------------------------------------
+//-- actMessage to ZONE_MSG, a clock zone is left alone
+static void displayMessage(textPosition_t align, uint16_t pause, textEffect_t fxIn, textEffect_t fxOut)
+{
+  P.displayZoneText(ZONE_MSG, actMessage, align, (MAX_SPEED - settingTextSpeed), pause, fxIn, fxOut);
+  P.displayReset(ZONE_MSG);
+
+} // displayMessage()
+
+
+//---------------------------------------------------------------------
+//-- The display is one ZONE_MSG over settingDisplayModules or, with
+//-- settingClockModules > 0, ZONE_MSG on the right and a fixed ZONE_CLOCK
+//-- on the left. MD_Parola sets up its zones only once, so a new layout
+//-- is used after a reboot.
+static void displayBegin()
+{
+  uint8_t last = settingDisplayModules -1;
+
+  clockZone = (settingClockModules > 0);
+  P.begin(clockZone ? 2 : 1);
+  if (clockZone)
+  {
+    P.setZone(ZONE_MSG,   0, last - settingClockModules);
+    P.setZone(ZONE_CLOCK, last - settingClockModules +1, last);
+    snprintf(clockMsg, sizeof(clockMsg), "--:--");
+    P.displayZoneText(ZONE_CLOCK, clockMsg, PA_CENTER, 0, 0, PA_PRINT, PA_NO_EFFECT);
+  }
+  else  P.setZone(ZONE_MSG, 0, last);
+  P.displayClear();
+  P.displaySuspend(false);
+  displayMessage(PA_LEFT, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT);   //-- empty, done at once
+  DebugTf("display [%d] modules, clock zone [%d] modules\r\n", settingDisplayModules, settingClockModules);
+
+} // displayBegin()
+
+
+//---------------------------------------------------------------------
+//-- called from loop(): ZONE_CLOCK is only redrawn when the minute
+//-- changed, in between PA_NO_EFFECT leaves it on the display
+static void clockZoneLoop()
+{
+  static uint32_t checkTimer  = 0;
+  static int8_t   shownMinute = -1;
+
+  if (!clockZone || !(bootStatus & BOOT_NTP))  return;
+  if ((millis() - checkTimer) < 1000)          return;
+  checkTimer = millis();
+  if (clockMinute() == shownMinute)            return;
+  shownMinute = clockMinute();
+
+  snprintf(clockMsg, sizeof(clockMsg), "%02d:%02d", clockHour(), shownMinute);
+  P.displayReset(ZONE_CLOCK);
+
+} // clockZoneLoop()
+
+
 //---------------------------------------------------------------------
 char *updateTime()
 {
-  snprintf(timeMsg, 20, "%02d : %02d", hour(), minute()); 
+  snprintf(timeMsg, 20, "%02d : %02d", clockHour(), clockMinute()); 
   return timeMsg;
 
 } // updateTime()
 
 
 //---------------------------------------------------------------------
-void splitNewsNoWords(const char *noNo)
+//-- false if there is no news to show
+static bool nextNieuwsBericht(char *dest)
+{
+  uint32_t slots = messageSlots("NWS") & ((2UL << settingNewsMaxMsg) -1);
+  int8_t   next  = nextMessageSlot(slots, newsMsgID);
+  
+  if (next < 0) return false;
+  newsMsgID = next;
+  readFileById("NWS", newsMsgID);
+  snprintf(dest, NEWS_SIZE, "** %s **", fileMessage);
+  //DebugTf("newsMsgID[%d] %s\r\n", newsMsgID, dest);
+  return true;
+  
+} // nextNieuwsBericht()
+
+
+//---------------------------------------------------------------------
+//-- false if there are no (not urgent) local messages at all
+static bool nextLocalBericht(char *dest)
 {
-  DebugTln(noNo);
-  int8_t wc = splitString(String(noNo), ' ', noWords, MAX_NO_NO_WORDS);
-  for(int8_t i=0; i<wc; i++)
+  uint32_t slots = messageSlots("LCL") & ~urgentMessages() & ((2UL << settingLocalMaxMsg) -1);
+  int8_t   next  = nextMessageSlot(slots, localMsgID);
+  
+  if (next < 0) return false;
+  bool wrapped = (next <= localMsgID);
+  localMsgID   = next;
+  readFileById("LCL", localMsgID);
+  if (wrapped && (localMsgID == 0)) getRevisionData();
+
+  snprintf(dest, LOCAL_SIZE, "** %s **", fileMessage);
+  //DebugTf("localMsgID[%d] %s\r\n", localMsgID, dest);
+    
+  if (schedDue(SCHED_REVISION))
   {
-    noWords[i].trim();
-    if (noWords[i].length() > 1)
-    {
-      noWords[i].toLowerCase();
-      DebugTf("NoNoWord[%d] [%s]\r\n", i, noWords[i].c_str());
-    }
+    schedRun(SCHED_REVISION, 900000);
+    getRevisionData();
   }
+  return true;
+
+} // nextLocalBericht()
+
+
+//---------------------------------------------------------------------
+//-- false if there are no urgent messages
+static bool nextUrgentBericht(char *dest)
+{
+  static uint8_t urgentMsgID = 0;
+  int8_t         next = nextMessageSlot(urgentMessages(), urgentMsgID);
   
-} // splitNewsNoWords()
+  if (next < 0) return false;
+  urgentMsgID = next;
+  readFileById("LCL", urgentMsgID);
+  snprintf(dest, LOCAL_SIZE, "!! %s !!", fileMessage);
+  return true;
+
+} // nextUrgentBericht()
+
 
 //---------------------------------------------------------------------
-bool hasNoNoWord(const char *cIn)
+//-- The next playlist entry is looked up, read and formatted in a free
+//-- queueStuff entry while the previous one is still on the display.
+//-- prepareNextMessage() is the producer, showNextMessage() the consumer:
+//-- they share nothing but the queue, so the producer can move to its
+//-- own task (with fetching and the web server) without locking.
+#define NEXT_SCROLL     0
+#define NEXT_WEEKDAY    1
+#define NEXT_TIME       2
+
+#define EMPTY_ROUND_WAIT  1000    // ms before a round that found nothing is tried again
+
+static queuedMsg *shownMsg  = NULL;         // queueRead(0) while on the display
+static uint8_t    actSource = PLAY_NONE;
+static bool       clockTime = false;        // the time follows the weekday
+static uint32_t   emptyRoundAt  = 0;        // millis() of a round with nothing to show
+static uint32_t   emptyRoundSig = 0;        // playSources() of that round
+
+//---------------------------------------------------------------------
+//-- changes when a source may have something to show (again)
+static uint32_t playSources()
 {
-  for(int8_t i=0; i<MAX_NO_NO_WORDS; i++)
+  uint32_t state[4] = { messageSlots("LCL"), messageSlots("NWS"), urgentMessages()
+                      , (uint32_t)(bootStatus << 1) | (tempMessage[0] != '\0') };
+  
+  return calcCRC32(state, sizeof(state));
+  
+} // playSources()
+
+
+//---------------------------------------------------------------------
+static void prepareNextMessage()
+{
+#ifdef NET_TASK_CORE
+  //-- an urgent message cuts in: the prepared entry makes way and the
+  //-- urgent one is marked, displayLoop() cuts short the news it shows
+  bool interrupted = playlistInterrupted();
+  if (interrupted)
+  {
+    queuedMsg *prepared = queueNewest();
+    if (prepared != NULL && prepared->source != PLAY_URGENT) queueDrop(prepared);
+    clockTime = false;
+  }
+  else if (queueCount() >= QUEUE_PREPARED) return;   //-- the rest is for a cut in
+#endif
+  queuedMsg *next = queueWrite();
+  bool       ready = false;
+
+  if (next == NULL) return;     //-- one is prepared already
+
+  next->kind   = NEXT_SCROLL;
+  next->cutIn  = false;
+  next->source = PLAY_NONE;
+  next->fxIn   = 0;
+  next->fxOut  = 0;
+  if (showIPaddress)
+  {
+    showIPaddress = false;
+    snprintf(next->text, NEWS_SIZE, "%03d.%03d.%d.%d", WiFi.localIP()[0], WiFi.localIP()[1]
+                                                      , WiFi.localIP()[2], WiFi.localIP()[3]);
+    DebugTf("\nAssigned IP[%s]\r\n", next->text);
+    queuePublish();
+    return;
+  }
+  if (clockTime)
+  {
+    clockTime    = false;
+    schedRun(SCHED_CLOCK, 60000);
+    next->kind   = NEXT_TIME;       //-- formatted when it is shown
+    next->source = PLAY_CLOCK;
+    next->fxIn   = random(0, ARRAY_SIZE(effect));
+    next->fxOut  = random(0, ARRAY_SIZE(effect));
+    queuePublish();
+    return;
+  }
+  if (bootStatus & BOOT_NTP) expireMessages(now());
+
+  //-- the last round found nothing: not again until a message changes
+  uint32_t sources = playSources();
+  if (emptyRoundAt != 0 && sources == emptyRoundSig && (millis() - emptyRoundAt) < EMPTY_ROUND_WAIT)
   {
-    String sIn = String(cIn);
-    sIn.toLowerCase();
-    int idx = sIn.indexOf(noWords[i]);
-    if ((idx > -1) && (noWords[i].length() > 1))  // yes! it's in there somewhere
+    valueIntensity = calculateIntensity();
+    return;
+  }
+
+  //-- skip entries that have nothing to show, at most one round
+  for (uint8_t entry=0; (entry <= playlistLength() && !ready); entry++)
+  {
+    next->source = playlistNext(urgentMessages() != 0);
+    
+    switch(next->source)
     {
-      DebugTf("found [%s]\r\n", noWords[i].c_str());
-      return true;      
-    }
+      case PLAY_URGENT:   ready = nextUrgentBericht(next->text);
+                          break;
+      case PLAY_CLOCK:    if (clockZone)                break;   //-- always on the display
+                          if (!(bootStatus & BOOT_NTP)) break;   //-- no time yet
+                          if (!schedDue(SCHED_CLOCK))   break;
+                          next->fxIn  = random(0, ARRAY_SIZE(effect));
+                          next->fxOut = random(0, ARRAY_SIZE(effect));
+                          snprintf(next->text, NEWS_SIZE, "%s", weekDayName[weekday()]);
+                          next->kind  = NEXT_WEEKDAY;
+                          clockTime   = true;
+                          ready       = true;
+                          break;
+      case PLAY_LOCAL:    ready = nextLocalBericht(next->text);
+                          break;
+      case PLAY_NEWS:     if (settingNewsInterval > 0)
+                                ready = nextNieuwsBericht(next->text);
+                          break;
+      case PLAY_WEATHER:  if (settingWeerLiveInterval > 0 && tempMessage[0] != '\0')
+                          {
+                            snprintf(next->text, NEWS_SIZE, "** %s **", tempMessage);
+                            Debugf("\t[%s]\r\n", next->text);
+                            ready = true;
+                          }
+                          break;
+    } // switch()
   }
-  //DebugTln("no NoNo words found!");
-  return false;
+  if (ready)
+  {
+    emptyRoundAt = 0;
+#ifdef NET_TASK_CORE
+    next->cutIn  = (interrupted && next->source == PLAY_URGENT);
+#endif
+    queuePublish();
+  }
+  else
+  {
+    emptyRoundAt  = millis() | 1;
+    emptyRoundSig = sources;
+  }
+
+  valueIntensity = calculateIntensity(); // latest value from sampleLDR()
   
-} // hasNoNoWord()
+} // prepareNextMessage()
 
 
 //---------------------------------------------------------------------
-void nextNieuwsBericht()
+//-- false if nothing was prepared yet
+static bool showNextMessage()
 {
-  bool breakOut  = false;
-  newsMsgID++;
-  if (newsMsgID >= settingNewsMaxMsg) newsMsgID = 0;
-  while (!readFileById("NWS", newsMsgID))
+  queuedMsg *next = queueRead((shownMsg != NULL) ? 1 : 0);
+
+  //-- made way for an urgent message, released with the next one
+  while (next != NULL && queueDropped(next))
   {
-    DebugTln("File not found!");
-    newsMsgID++;
-    if (newsMsgID > settingNewsMaxMsg) 
+    if (shownMsg != NULL) queueRelease();
+    shownMsg = next;
+    next     = queueRead(1);
+  }
+  if (next == NULL) return false;
+  if (shownMsg != NULL) queueRelease();   //-- Parola lets go of it below
+  shownMsg   = next;
+  actMessage = next->text;
+  actSource  = next->source;
+  inFX       = next->fxIn;
+  outFX      = next->fxOut;
+  pushDisplayed();
+  
+  P.setIntensity(valueIntensity);
+  switch(next->kind)
+  {
+    case NEXT_WEEKDAY:  displayMessage(PA_CENTER, 1000, effect[inFX], effect[outFX]);
+                        break;
+    case NEXT_TIME:     snprintf(actMessage, NEWS_SIZE, "%s", updateTime());
+                        displayMessage(PA_CENTER, 2000, effect[inFX], effect[outFX]);
+                        break;
+    default:            displayMessage(PA_LEFT, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
+  }
+  return true;
+  
+} // showNextMessage()
+
+
+//---------------------------------------------------------------------
+static void startHTTPserver()
+{
+  setupFSexplorer();
+  setupAssets();
+  httpServer.on("/",          sendIndexPage);
+  httpServer.on("/index",     sendIndexPage);
+  httpServer.on("/index.html",sendIndexPage);
+  // all other api calls are catched in FSexplorer onNotFounD!
+  httpServer.on("/api", HTTP_GET, processAPI);
+  startUpdateServer();
+
+  httpServer.begin();
+  DebugTln("\nServer started\r");
+  
+} // startHTTPserver()
+
+
+//---------------------------------------------------------------------
+//-- brings up WiFi, mDNS, the HTTP server and NTP in the background
+//-- (called from loop()), bootStatus tells what is ready
+static void bootLoop()
+{
+  if (!(bootStatus & BOOT_WIFI))
+  {
+    if (WiFi.status() == WL_CONNECTED)
+    {
+      bootStatus |= BOOT_WIFI;
+      digitalWrite(LED_BUILTIN, LOW);
+      InfoTf("WiFi connected after [%u]ms, IP[%s]\r\n", millis()
+                                      , WiFi.localIP().toString().c_str());
+      Serial.print("\nGebruik 'telnet ");
+      Serial.print (WiFi.localIP());
+      Serial.println("' voor verdere debugging\r\n");
+      startMDNS(settingHostname);
+      bootStatus |= BOOT_MDNS;
+      startHTTPserver();
+      bootStatus |= BOOT_HTTP;
+      showIPaddress = true;   //-- it is the next message
+      return;
+    }
+    if (!(bootStatus & BOOT_PORTAL) && (millis() > BOOT_WIFI_TIMEOUT))
     {
-      newsMsgID = 0;
-      breakOut  = true;
-      break;
+      //-- no (known) WiFi: the WiFiManager portal blocks until it is configured
+      bootStatus |= BOOT_PORTAL;
+      DebugTln("Attempting to connect to WiFi network\r");
+      snprintf(portalMsg, sizeof(portalMsg), "Connect to AP '%s' and configure WiFi on  192.168.4.1   ", _HOSTNAME);
+#ifndef NET_TASK_CORE
+      actMessage = portalMsg;
+      displayMessage(PA_LEFT, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
+      do { yield(); P.displayAnimate(); } while( !P.getZoneStatus(ZONE_MSG) );
+#endif
+      //-- with NET_TASK_CORE displayLoop() keeps showing portalMsg
+      startWiFi(_HOSTNAME, 240);  // timeout 4 minuten
     }
+    return;
   }
-  if (!breakOut)
+
+  if (!(bootStatus & BOOT_NTP) && (timeStatus() == timeSet))
   {
-    snprintf(actMessage, NEWS_SIZE, "** %s **", fileMessage);
-    //DebugTf("newsMsgID[%d] %s\r\n", newsMsgID, actMessage);
-    utf8Ascii(actMessage);
-    P.displayScroll(actMessage, PA_LEFT, PA_SCROLL_LEFT, (MAX_SPEED - settingTextSpeed));
+    bootStatus |= BOOT_NTP;
+    //-- BearSSL checks the certificate dates against the system clock
+    timeval tv = { UTC.now(), 0 };
+    settimeofday(&tv, NULL);
+    CET.setLocation(F("Europe/Amsterdam"));
+    CET.setDefault(); 
+    DebugTln("UTC time: "+ UTC.dateTime());
+    DebugTln("CET time: "+ CET.dateTime());
+    InfoTf("time synced after [%u]ms\r\n", millis());
+
+    nrReboots++;
+    writeLastStatus();
+    snprintf(cMsg, sizeof(cMsg), "REBOOT [%u] reason [%s]", nrReboots, lastReset.c_str());
+    writeToLog(cMsg);
   }
   
-} // nextNieuwsBericht()
+} // bootLoop()
 
 
 //---------------------------------------------------------------------
-void nextLocalBericht()
+//-- WiFi, the webserver, the fetches and the producer side of queueStuff
+//-- (prepareNextMessage()). With NET_TASK_CORE the loop of networkTask(),
+//-- else the first half of loop()
+static void networkLoop()
 {
-  bool nothingThere = false;
+//handleNTP();
+  timeSnapshot();   //-- before bootLoop() sets BOOT_NTP
+  bootLoop();
+  events(); // trigger ezTime update etc.
+  if (bootStatus & BOOT_HTTP) httpServer.handleClient();
+  if (bootStatus & BOOT_MDNS) platformMdnsLoop();
+  yield();
   
-  localMsgID++;
-  if (localMsgID > settingLocalMaxMsg) 
+  //-- only one fetch at a time, a due fetch waits for the running one.
+  //-- The next one is scheduled by schedDone() in onWeerLiveDone() and
+  //-- onNewsDone(), with a backoff when it failed
+  if ((bootStatus & BOOT_WIFI) && schedDue(SCHED_WEATHER) && !fetchBusy())
   {
-    localMsgID    = 0;
-    nothingThere  = true;
+    if ((settingWeerLiveInterval > 0) && (strlen(settingWeerLiveAUTH) > 5))
+    {
+      schedRun(SCHED_WEATHER, settingWeerLiveInterval * (60 * 1000UL)); // Interval in Minutes!
+      getWeerLiveData();
+    }
+    else  schedRun(SCHED_WEATHER, SCHED_OFF_CHECK);
   }
-  while (!readFileById("LCL", localMsgID))
+
+  if ((bootStatus & BOOT_WIFI) && schedDue(SCHED_NEWS) && !fetchBusy())
   {
-    DebugTf("File [/newsFiles/LCL-%03d] not found!\r\n", localMsgID);
-    localMsgID++;
-    if (localMsgID > settingLocalMaxMsg) 
+    if ((settingNewsInterval > 0) && (strlen(settingNewsAUTH) > 5))
     {
-      DebugTln("Back to LCL-000, exit while-loop");
-      localMsgID = 0;
-      continue;
+      schedRun(SCHED_NEWS, settingNewsInterval * (60 * 1000UL)); // Interval in Minutes!
+      getNewsapiData();
     }
+    else  schedRun(SCHED_NEWS, SCHED_OFF_CHECK);
   }
-  if (nothingThere && (localMsgID == 0)) 
-  { 
-    nothingThere = true;
-    getRevisionData();
+
+  fetchLoop();  // move a running fetch forward a bit
+  logDrain();
+  sysLogLoop();
+  settingsLoop();
+  if (bootStatus & BOOT_HTTP) pushLoop();
+#ifdef NET_TASK_CORE
+  prepareNextMessage();   //-- only if it is not done already
+#endif
+
+} // networkLoop()
+
+
+#ifdef NET_TASK_CORE
+//---------------------------------------------------------------------
+//-- an entry after the one on the display that cuts it short
+static bool cutInWaiting()
+{
+  uint8_t count = queueCount();
+
+  for (uint8_t n=1; n<count; n++)
+  {
+    queuedMsg *msg = queueRead(n);
+    if (msg->cutIn && !queueDropped(msg)) return true;
   }
-  else  nothingThere = false;
+  return false;
 
-  snprintf(actMessage, LOCAL_SIZE, "** %s **", fileMessage);
-  //DebugTf("localMsgID[%d] %s\r\n", localMsgID, actMessage);
-  utf8Ascii(actMessage);
-  P.displayScroll(actMessage, PA_LEFT, PA_SCROLL_LEFT, (MAX_SPEED - settingTextSpeed));
-    
-  if ((millis() - revisionTimer) > 900000)
+} // cutInWaiting()
+#endif
+
+
+//---------------------------------------------------------------------
+//-- the display and the consumer side of queueStuff (showNextMessage()),
+//-- with NET_TASK_CORE all of loop() (core 1)
+static void displayLoop()
+{
+  sampleLDR();
+
+  metricsFrameStart();
+#ifdef NET_TASK_CORE
+  //-- prepareNextMessage() dropped what it had prepared and published
+  //-- the urgent message, only the one on the display goes
+  if (actSource == PLAY_NEWS && cutInWaiting())
   {
-    revisionTimer = millis();
-    getRevisionData();
+    P.displayClear(ZONE_MSG);
+    if (shownMsg != NULL) queueRelease();
+    shownMsg   = NULL;
+    actMessage = (char*)"";
+    actSource  = PLAY_NONE;
+    if (!showNextMessage()) displayMessage(PA_LEFT, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
+  }
+#else
+  //-- a new urgent message cuts short the news on the display
+  if (playlistInterrupted() && actSource == PLAY_NEWS)
+  {
+    //-- drop the one on the display and the prepared one, the urgent
+    //-- message is the next
+    P.displayClear(ZONE_MSG);
+    while (queueCount() > 0) queueRelease();
+    shownMsg   = NULL;
+    actMessage = (char*)"";
+    actSource  = PLAY_NONE;
+    prepareNextMessage();
+    if (!showNextMessage()) displayMessage(PA_LEFT, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
+  }
+#endif
+  clockZoneLoop();
+  P.displayAnimate();
+  if (P.getZoneStatus(ZONE_MSG)) // done with animation, ready for next message
+  {
+    uint32_t gapStart = micros();
+#ifndef NET_TASK_CORE
+    prepareNextMessage();   //-- only if it is not done already
+#endif
+    if (showNextMessage())
+    {
+      metricsMessageGap(gapStart);
+      if (firstScrollMs == 0)
+      {
+        firstScrollMs = millis();
+        InfoTf("first message after [%u]ms\r\n", firstScrollMs);
+      }
+      DebugTf("Animate IN[%d], OUT[%d] %s\r\n", inFX, outFX, actMessage);
+    }
+#ifdef NET_TASK_CORE
+    else if ((bootStatus & BOOT_PORTAL) && !(bootStatus & BOOT_WIFI))
+    {
+      //-- networkTask() is in the WiFiManager portal
+      actMessage = portalMsg;
+      displayMessage(PA_LEFT, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
+    }
+#endif
+  } // dislayAnimate()
+#ifndef NET_TASK_CORE
+  else  prepareNextMessage();
+#endif
+
+} // displayLoop()
+
+
+#ifdef NET_TASK_CORE
+//---------------------------------------------------------------------
+//-- networkLoop() on NET_TASK_CORE, so a TLS handshake or a webpage
+//-- does not stop the scrolling on the other core
+static void networkTask(void *param)
+{
+  (void)param;
+  for(;;)
+  {
+    networkLoop();
+    //-- a tick for the idle task of this core (task watchdog)
+    vTaskDelay(1);
   }
 
-} // nextLocalBericht()
+} // networkTask()
+#endif
 
 
 //=====================================================================
@@ -255,28 +704,23 @@ void setup()
   Serial.begin(115200);
   while(!Serial) { /* wait a bit */ }
 
-  lastReset     = ESP.getResetReason();
+  lastReset     = platformResetReason();
 
   startTelnet();
   
   DebugTln("\r\n[MD_Parola WiFi Message Display]\r\n");
   DebugTf("Booting....[%s]\r\n\r\n", String(_FW_VERSION).c_str());
   
-  P.begin();
-  P.displayClear();
-  P.displaySuspend(false);
-  P.displayScroll(actMessage, PA_LEFT, PA_SCROLL_LEFT, (MAX_SPEED - settingTextSpeed));
-
-  actMessage[0]  = '\0';
-  
 //================ LittleFS ===========================================
   if (LittleFS.begin()) 
   {
     DebugTln(F("LittleFS Mount succesfull\r"));
     LittleFSmounted = true;
+    sysLogBegin();
        
     readSettings(true);
     splitNewsNoWords(settingNewsNoWords);
+    loadMessageCache();
 
     if (settingNewsInterval == 0)
     {
@@ -284,112 +728,68 @@ void setup()
     }
     else
     {
-      if (!LittleFS.exists("/newsFiles/LCL-000"))
+      if (!hasMessage("LCL", 0))
       {
         char LCL000[100];
         sprintf(LCL000, "ESP_ticker %s by Willem Aandewiel", String(_FW_VERSION).c_str());
         writeFileById("LCL", 0, LCL000);
       }
-      if (!LittleFS.exists("/newsFiles/LCL-001"))
+      if (!hasMessage("LCL", 1))
       {
         char LCL001[100];
         sprintf(LCL001, "ESP_ticker %s by Willem Aandewiel", String(_FW_VERSION).c_str());
         writeFileById("LCL", 1, LCL001);
       }
-      writeFileById("NWS", 1, "(c) 2021 Willem Aandewiel");
+      if (!hasMessage("NWS", 1)) writeFileById("NWS", 1, "(c) 2021 Willem Aandewiel");
     }
   } 
   else 
   { 
-    DebugTln(F("LittleFS Mount failed\r"));   // Serious problem with LittleFS 
+    ErrorTf("LittleFS Mount failed\r\n");   // Serious problem with LittleFS 
     LittleFSmounted = false;
   }
+  displayBegin();     //-- after readSettings(), it needs the layout
+  playlistBuild();
   //==========================================================//
   // writeLastStatus();  // only for firsttime initialization //
   //==========================================================//
   readLastStatus(); // place it in actTimestamp
 
-  // attempt to connect to Wifi network:
-  int t = 0;
-  while ((WiFi.status() != WL_CONNECTED) && (t < 25))
-  {
-    delay(500);
-    Serial.print(".");
-    t++;
-  }
-  if ( WiFi.status() != WL_CONNECTED) {
-    DebugTln("Attempting to connect to WiFi network\r");
-    sprintf(actMessage, "Connect to AP '%s' and configure WiFi on  192.168.4.1   ", _HOSTNAME);
-    P.setTextEffect(PA_SCROLL_LEFT, PA_NO_EFFECT);
-    do { yield(); } while( !P.displayAnimate() );
-    //P.print("   192.168.4.1");
-  }
-  // Connect to and initialise WiFi network
-  digitalWrite(LED_BUILTIN, HIGH);
-  startWiFi(_HOSTNAME, 240);  // timeout 4 minuten
-  digitalWrite(LED_BUILTIN, LOW);
-
-  startMDNS(settingHostname);
-    
-  //--- ezTime initialisation
-  setDebug(INFO);  
-  waitForSync(); 
-  CET.setLocation(F("Europe/Amsterdam"));
-  CET.setDefault(); 
-  
-  DebugTln("UTC time: "+ UTC.dateTime());
-  DebugTln("CET time: "+ CET.dateTime());
+  readLastWeather(tempMessage, LOCAL_SIZE);
 
-  nrReboots++;
-  writeLastStatus();
-  //writeToLog("=========REBOOT==========================");
-
-  snprintf(cMsg, sizeof(cMsg), "Last reset reason: [%s]", ESP.getResetReason().c_str());
+  snprintf(cMsg, sizeof(cMsg), "Last reset reason: [%s]", lastReset.c_str());
   DebugTln(cMsg);
-  //writeToLog(cMsg);
-
-  Serial.print("\nGebruik 'telnet ");
-  Serial.print (WiFi.localIP());
-  Serial.println("' voor verdere debugging\r\n");
-
-//================ Start HTTP Server ================================
-  setupFSexplorer();
-  httpServer.serveStatic("/FSexplorer.png",   LittleFS, "/FSexplorer.png");
-  httpServer.on("/",          sendIndexPage);
-  httpServer.on("/index",     sendIndexPage);
-  httpServer.on("/index.html",sendIndexPage);
-  httpServer.serveStatic("/index.css", LittleFS, "/index.css");
-  httpServer.serveStatic("/index.js",  LittleFS, "/index.js");
-  // all other api calls are catched in FSexplorer onNotFounD!
-  httpServer.on("/api", HTTP_GET, processAPI);
-
 
-  httpServer.begin();
-  DebugTln("\nServer started\r");
-  
-  // Set up first message as the IP address
-  sprintf(actMessage, "%03d.%03d.%d.%d", WiFi.localIP()[0], WiFi.localIP()[1], WiFi.localIP()[2], WiFi.localIP()[3]);
-  DebugTf("\nAssigned IP[%s]\r\n", actMessage);
-  P.displayScroll(actMessage, PA_LEFT, PA_NO_EFFECT, (MAX_SPEED - settingTextSpeed));
-  P.setTextEffect(PA_SCROLL_LEFT, PA_NO_EFFECT);
+  //--- ezTime syncs in events(), bootLoop() sets the timezone once it has
+  setDebug(INFO);  
   
-  valueIntensity = calculateIntensity(); // read analog input pin 0
-
+#if defined(ESP32)
+  analogReadResolution(10);   //-- the LDR settings are for the 0..1023 of the ESP8266
+#endif
+  sampleLDR();   // first sample of analog input pin 0
+  valueIntensity = calculateIntensity();
   P.setIntensity(valueIntensity);
-  newsMsgID = 0;
-  do { yield(); } while( !P.displayAnimate() );
-
   P.setFont(ExtASCII);
+  P.setTextEffect(ZONE_MSG, PA_SCROLL_LEFT, PA_NO_EFFECT);
 
+  newsMsgID = 0;
   inFX = 0;
   outFX= 0;
+  schedBegin(platformChipId());
 
-  for (int i=0; i<=settingNewsMaxMsg; i++)
-  {
-    writeFileById("NWS", i, "");
-    //DebugTf("readFileById(NWS, %d)\r\n", i);
-    //readFileById("NWS", i);
-  }
+  //-- connect with the stored credentials, bootLoop() does the rest
+  //-- while the display already shows the stored messages
+  WiFi.mode(WIFI_STA);
+  platformSetHostname(settingHostname);
+  WiFi.begin();
+  digitalWrite(LED_BUILTIN, HIGH);
+
+  logSetBlocking(false);  //-- from here on logDrain() in loop() sends the log
+
+#ifdef NET_TASK_CORE
+  xTaskCreatePinnedToCore(networkTask, "network", NET_TASK_STACK, NULL
+                                     , NET_TASK_PRIO, NULL, NET_TASK_CORE);
+#endif
   
 } // setup()
 
@@ -397,100 +797,16 @@ void setup()
 //=====================================================================
 void loop()
 {
-//handleNTP();
-  events(); // trigger ezTime update etc.
-  httpServer.handleClient();
-  MDNS.update();
-  yield();
-  
-  if ((millis() > weerTimer) && (strlen(settingWeerLiveAUTH) > 5))
-  {
-    weerTimer = millis() + (settingWeerLiveInterval * (60 * 1000)); // Interval in Minutes!
-    if (settingWeerLiveInterval > 0)  getWeerLiveData();
-  }
-
-  if ((millis() > newsapiTimer) && (strlen(settingNewsAUTH) > 5))
-  {
-    newsapiTimer = millis() + (settingNewsInterval * (60 * 1000)); // Interval in Minutes!
-    if (settingNewsInterval > 0) 
-    {
-      if (!getNewsapiData())  //-- first try ...
-      {
-        delay(100);
-        if (!getNewsapiData())  //-- second try ...
-        {
-          //-- try again in two(2) minutes ...
-          newsapiTimer = millis() + (2 * (60 * 1000)); // Interval in Minutes!
-        }
-      }
-    }
-  }
-
-  if (P.displayAnimate()) // done with animation, ready for next message
-  {
-    yield();
-    msgType++;
-    DebugTf("msgType[%d]\r\n", msgType);
-    
-    switch(msgType)
-    {
-      case 1:   if (!(millis() > timeTimer))  return;
-                inFX  = random(0, ARRAY_SIZE(effect));
-                outFX = random(0, ARRAY_SIZE(effect));
-                snprintf(actMessage, LOCAL_SIZE, weekDayName[weekday()]);
-                P.displayText(actMessage, PA_CENTER, (MAX_SPEED - settingTextSpeed), 1000, effect[inFX], effect[outFX]);
-                DebugTf("Animate IN[%d], OUT[%d] %s\r\n", inFX, outFX, actMessage);
-                break;
-      case 2:   if (!(millis() > timeTimer))  return;
-                timeTimer = millis() + 60000;
-                inFX  = random(0, ARRAY_SIZE(effect));
-                outFX = random(0, ARRAY_SIZE(effect));
-                sprintf(actMessage, "%s", updateTime());
-                P.displayText(actMessage, PA_CENTER, (MAX_SPEED - settingTextSpeed), 2000, effect[inFX], effect[outFX]);
-                DebugTf("Animate IN[%d], OUT[%d] %s\r\n", inFX, outFX, actMessage);
-                break;
-      case 3:   nextLocalBericht();
-                P.setTextEffect(PA_SCROLL_LEFT, PA_NO_EFFECT);
-                break;          
-      case 6:   nextLocalBericht();
-                P.setTextEffect(PA_SCROLL_LEFT, PA_NO_EFFECT);
-                break;    
-      case 4:            
-      case 5:            
-      case 7:            
-      case 8:   if (settingNewsInterval > 0)
-                      nextNieuwsBericht();
-                else  nextLocalBericht();
-                P.setTextEffect(PA_SCROLL_LEFT, PA_NO_EFFECT);
-                break;
-      case 9:   if (settingWeerLiveInterval > 0)
-                {
-                  snprintf(actMessage, LOCAL_SIZE, "** %s **", tempMessage);
-                  Debugf("\t[%s]\r\n", actMessage);
-                  utf8Ascii(actMessage);
-                }
-                else  nextLocalBericht();
-                P.setTextEffect(PA_SCROLL_LEFT, PA_NO_EFFECT);
-                break;
-      case 10:  if (settingNewsInterval > 0)
-                      nextNieuwsBericht();
-                else  nextLocalBericht();
-                break;
-      default:  msgType = 0;
-                return;
-                
-    } // switch()
-
-    //DebugTln(actMessage);
-    valueIntensity = calculateIntensity(); // read analog input pin 0
-    DebugTf("Intensity set to [%d]\r\n", valueIntensity);
-    P.setIntensity(valueIntensity);
-    // Tell Parola we have a new animation
-    P.displayReset();
-    DebugTln("End of displayAnimate()..");
-    
-  } // dislayAnimate()
-
+  metricsLoopStart();
+#ifndef NET_TASK_CORE
+  networkLoop();
+#endif
+  displayLoop();
+
+#ifndef NET_TASK_CORE
+  //-- no fetch running or due soon: give the SDK a ms (WiFi modem sleep)
+  if (!fetchBusy() && (schedIdleMs() > SCHED_IDLE_MIN)) delay(1);
+#endif
   
 } // loop()
 
@@ -67,8 +67,8 @@ void setupFSexplorer()    // Funktionsaufruf "spiffs();" muss im Setup eingebund
   
   if (LittleFS.exists("/FSexplorer.html")) 
   {
-    httpServer.serveStatic("/FSexplorer.html", LittleFS, "/FSexplorer.html");
-    httpServer.serveStatic("/FSexplorer",      LittleFS, "/FSexplorer.html");
+    serveAsset("/FSexplorer.html", "/FSexplorer.html");
+    serveAsset("/FSexplorer",      "/FSexplorer.html");
   }
   else 
   {
@@ -81,10 +81,10 @@ void setupFSexplorer()    // Funktionsaufruf "spiffs();" muss im Setup eingebund
   httpServer.on("/update", updateFirmware);
   httpServer.onNotFound([]() 
   {
-    if (Verbose) DebugTf("in 'onNotFound()'!! [%s] => \r\n", String(httpServer.uri()).c_str());
+    if (Verbose) DebugTf("in 'onNotFound()'!! [%s] => \r\n", httpServer.uri().c_str());
     if (httpServer.uri().indexOf("/api/") == 0) 
     {
-      if (Verbose) DebugTf("next: processAPI(%s)\r\n", String(httpServer.uri()).c_str());
+      if (Verbose) DebugTf("next: processAPI(%s)\r\n", httpServer.uri().c_str());
       processAPI();
     }
     else if (httpServer.uri() == "/")
@@ -107,74 +107,167 @@ void setupFSexplorer()    // Funktionsaufruf "spiffs();" muss im Setup eingebund
 
 
 //=====================================================================================
-void APIlistFiles()             // Senden aller Daten an den Client
-{   
-  FSInfo LittleFSinfo;
+//-- api/listfiles[?dir=/newsFiles][&recursive=1][&sort=none][&limit=n][&after=cursor]
+//-- Every page is one pass over the directory that keeps only the next 'limit'
+//-- entries, so any number of files is listed with the same (stack) memory.
+//-- With sort=name (default) the cursor is the last name of the previous page,
+//-- with sort=none it is the number of entries already listed.
+typedef struct _fileMeta {
+  char      Name[LIST_NAME_MAX];
+  uint32_t  Size;
+} fileMeta;
 
-  typedef struct _fileMeta {
-    char    Name[30];     
-    int32_t Size;
-  } fileMeta;
+typedef struct _listPage {
+  fileMeta *entry;
+  uint8_t   count;
+  uint8_t   limit;
+  bool      byName;
+  bool      recursive;
+  bool      more;         // entries after this page
+  char      after[LIST_NAME_MAX];
+  uint32_t  skip;         // sort=none: entries before this page
+  uint32_t  seen;
+} listPage;
 
-  _fileMeta dirMap[MAX_FILES_IN_LIST+1];
-  int fileNr = 0;
+//-------------------------------------------------------------------------------------
+static void listAdd(listPage *page, const char *name, uint32_t size)
+{
+  int8_t  at;
   
-  Dir dir = LittleFS.openDir("/");         // List files on LittleFS
-  while (dir.next() && (fileNr < MAX_FILES_IN_LIST))  
+  if (!page->byName)
   {
-    dirMap[fileNr].Name[0] = '\0';
-  //strncat(dirMap[fileNr].Name, dir.fileName().substring(1).c_str(), 29); // remove leading '/'
-    strncat(dirMap[fileNr].Name, dir.fileName().c_str(), 29); 
-    dirMap[fileNr].Size = dir.fileSize();
-    //--- Skip files in newsFiles map
-    //-aaw-if ((dir.fileName().indexOf("/newsFiles") == -1) && (dir.fileSize() > 0))
-    //{
-      fileNr++;
-    //}
+    if (page->seen++ < page->skip)  return;
+    if (page->count == page->limit)
+    {
+      page->more = true;
+      return;
+    }
+    at = page->count;
   }
-  DebugTf("fileNr[%d], Max[%d]\r\n", fileNr, MAX_FILES_IN_LIST);
+  else
+  {
+    if (page->after[0] != '\0' && strcmp(name, page->after) <= 0) return;
+    //-- insertion into the (sorted) page, the largest name drops off
+    for (at = page->count; at > 0 && strcmp(name, page->entry[at -1].Name) < 0; at--) ;
+    if (at == page->limit)
+    {
+      page->more = true;
+      return;
+    }
+    if (page->count == page->limit)
+    {
+      page->more = true;
+      page->count--;
+    }
+    memmove(&page->entry[at +1], &page->entry[at], (page->count - at) * sizeof(fileMeta));
+  }
+  strCopy(page->entry[at].Name, LIST_NAME_MAX, name);
+  page->entry[at].Size = size;
+  page->count++;
+  
+} // listAdd()
 
-  // -- bubble sort dirMap op .Name--
-  for (int8_t y = 0; y < fileNr; y++) {
-    yield();
-    for (int8_t x = y + 1; x < fileNr; x++)  {
-      //DebugTf("y[%d], x[%d] => seq[y][%s] / seq[x][%s] ", y, x, dirMap[y].Name, dirMap[x].Name);
-      if (compare(String(dirMap[x].Name), String(dirMap[y].Name)))  
-      {
-        //Debug(" !switch!");
-        fileMeta temp = dirMap[y];
-        dirMap[y] = dirMap[x];
-        dirMap[x] = temp;
-      } /* end if */
-      //Debugln();
-    } /* end for */
-  } /* end for */
+//-------------------------------------------------------------------------------------
+//-- path is "" for the root, names are listed without the leading '/'
+static void listDir(listPage *page, const char *path, uint8_t depth)
+{
+  char  fullName[LIST_NAME_MAX];
   
-  if (fileNr >= MAX_FILES_IN_LIST)
+  fsDir dir((path[0] == '\0') ? "/" : path);
+  while (dir.next())
   {
-    fileNr = MAX_FILES_IN_LIST;
-    dirMap[fileNr].Name[0] = '\0';
-    //--- if you change this message you also have to 
-    //--- change FSexplorer.html
-    strncat(dirMap[fileNr].Name, "More files not listed ..", 29); 
-    dirMap[fileNr].Size = 0;
-    fileNr++;
+    yield();
+    if (path[0] == '\0')  strCopy(fullName, sizeof(fullName), dir.fileName().c_str());
+    else                  snprintf(fullName, sizeof(fullName), "%s/%s", &path[1], dir.fileName().c_str());
+    
+    if (dir.isDirectory() && page->recursive && depth < LIST_MAX_DEPTH)
+    {
+      char subDir[LIST_NAME_MAX];
+      snprintf(subDir, sizeof(subDir), "/%s", fullName);
+      listDir(page, subDir, depth +1);
+    }
+    else  listAdd(page, fullName, dir.fileSize());
   }
+  
+} // listDir()
+
+//-------------------------------------------------------------------------------------
+static void sizeText(char *dest, int maxLen, uint32_t bytes)
+{
+  if (bytes < 1024)                 snprintf(dest, maxLen, "%u Byte", bytes);
+  else if (bytes < (1024 * 1024))   snprintf(dest, maxLen, "%.2f KB", bytes / 1024.0);
+  else                              snprintf(dest, maxLen, "%.2f MB", bytes / 1024.0 / 1024.0);
+  
+} // sizeText()
+
+//=====================================================================================
+void APIlistFiles()             // Senden aller Daten an den Client
+{   
+  fileMeta  entries[MAX_FILES_IN_LIST];
+  listPage  page;
+  char      path[LIST_NAME_MAX] = "";
+  char      text[20];
 
-  String temp = "[";
-  for (int f=0; f < fileNr; f++)  
+  memset(&page, 0, sizeof(page));
+  page.entry     = entries;
+  page.limit     = MAX_FILES_IN_LIST;
+  page.byName    = (httpServer.arg("sort") != "none");
+  page.recursive = (httpServer.arg("recursive") == "1");
+  if (httpServer.hasArg("limit"))
   {
-    DebugTf("[%3d] >> [%s]\r\n", f, dirMap[f].Name);
-    if (temp != "[") temp += ",";
-    temp += R"({"name":")" + String(dirMap[f].Name) + R"(","size":")" + formatBytes(dirMap[f].Size) + R"("})";
+    int limit = httpServer.arg("limit").toInt();
+    if (limit > 0 && limit < MAX_FILES_IN_LIST) page.limit = limit;
+  }
+  if (page.byName)  strCopy(page.after, sizeof(page.after), httpServer.arg("after").c_str());
+  else              page.skip = httpServer.arg("after").toInt();
+  if (httpServer.hasArg("dir") && httpServer.arg("dir") != "/")
+  {
+    snprintf(path, sizeof(path), "%s%s", (httpServer.arg("dir")[0] == '/') ? "" : "/"
+                                       , httpServer.arg("dir").c_str());
   }
 
-  LittleFS.info(LittleFSinfo);
-  temp += R"(,{"usedBytes":")" + formatBytes(LittleFSinfo.usedBytes * 1.05) + R"(",)" +       // Berechnet den verwendeten Speicherplatz + 5% Sicherheitsaufschlag
-          R"("totalBytes":")" + formatBytes(LittleFSinfo.totalBytes) + R"(","freeBytes":")" + // Zeigt die Größe des Speichers
-          (LittleFSinfo.totalBytes - (LittleFSinfo.usedBytes * 1.05)) + R"("}])";               // Berechnet den freien Speicherplatz + 5% Sicherheitsaufschlag
+  listDir(&page, path, 0);
+  DebugTf("listed [%d] files, more[%s]\r\n", page.count, page.more ? "yes" : "no");
+
+  sendStartJsonList();
+  for (int f=0; f < page.count; f++)  
+  {
+    sizeText(text, sizeof(text), page.entry[f].Size);
+    sendJsonListObjStart();
+    sendJsonListField("name", page.entry[f].Name);
+    sendJsonListField("size", text);
+    sendJsonListObjEnd();
+  }
+  if (page.more)
+  {
+    //--- older FSexplorer.html versions look for this message
+    sendJsonListObjStart();
+    sendJsonListField("name", "More files not listed ..");
+    sendJsonListField("size", "");
+    sendJsonListObjEnd();
+  }
 
-  httpServer.send(200, "application/json", temp);
+  uint32_t fsTotal = platformFsTotal();
+  uint32_t fsUsed  = platformFsUsed();
+  sendJsonListObjStart();
+  // Berechnet den verwendeten Speicherplatz + 5% Sicherheitsaufschlag
+  sizeText(text, sizeof(text), fsUsed * 1.05);
+  sendJsonListField("usedBytes", text);
+  sizeText(text, sizeof(text), fsTotal);
+  sendJsonListField("totalBytes", text);
+  snprintf(text, sizeof(text), "%u", (uint32_t)(fsTotal - (fsUsed * 1.05)));
+  sendJsonListField("freeBytes", text);
+  if (page.more)
+  {
+    if (page.byName)  sendJsonListField("next", page.entry[page.count -1].Name);
+    else
+    {
+      snprintf(text, sizeof(text), "%u", page.skip + page.count);
+      sendJsonListField("next", text);
+    }
+  }
+  sendJsonListObjEnd();
+  sendEndJsonList();
   
 } // APIlistFiles()
 
@@ -186,42 +279,120 @@ bool handleFile(String&& path)
   {
     DebugTf("Delete -> [%s]\n\r",  httpServer.arg("delete").c_str());
     LittleFS.remove(httpServer.arg("delete"));    // Datei löschen
+    assetChanged(httpServer.arg("delete").c_str());
     httpServer.sendContent(Header);
     return true;
   }
   if (!LittleFS.exists("/FSexplorer.html")) httpServer.send(200, "text/html", Helper); //Upload the FSexplorer.html
   if (path.endsWith("/")) path += "index.html";
+  if (path == SETTINGS_FILE) settingsExport();
   return LittleFS.exists(path) ? ({File f = LittleFS.open(path, "r"); httpServer.streamFile(f, contentType(path)); f.close(); true;}) : false;
 
 } // handleFile()
 
 
 //=====================================================================================
-void handleFileUpload() 
+//-- An upload goes to UPLOAD_TEMP through uploadBuf[], so LittleFS gets
+//-- whole pages. It is only started when the request (Content-Length)
+//-- fits in the free space. With '/upload?crc=<hex CRC32>' the data is
+//-- checked at the end. Only a complete and correct upload replaces the
+//-- target; the rename is atomic, a failed upload leaves the old file.
+static File     uploadFile;
+static uint8_t  uploadBuf[UPLOAD_BUF_SIZE];
+static uint16_t uploadBufLen  = 0;
+static uint32_t uploadCrc     = 0;
+static char     uploadTarget[LIST_NAME_MAX +2];
+static const char *uploadError = NULL;
+
+//-------------------------------------------------------------------------------------
+static void uploadFlush()
 {
-  static File fsUploadFile;
-  HTTPUpload& upload = httpServer.upload();
-  if (upload.status == UPLOAD_FILE_START) 
+  if (uploadBufLen == 0 || uploadError != NULL) return;
+  uint32_t start = micros();
+  if (uploadFile.write(uploadBuf, uploadBufLen) != uploadBufLen) uploadError = "507: write failed (full?)";
+  metricsFsOp(true, start);
+  uploadBufLen = 0;
+  
+} // uploadFlush()
+
+//-------------------------------------------------------------------------------------
+static void uploadStart(HTTPUpload& upload)
+{
+  uint32_t needed = httpServer.clientContentLength();
+  
+  uploadError  = NULL;
+  uploadBufLen = 0;
+  uploadCrc    = 0;
+  //-- the last 30 chars of the name
+  const char *name = upload.filename.c_str();
+  if (upload.filename.length() > 30) name += (upload.filename.length() - 30);
+  snprintf(uploadTarget, sizeof(uploadTarget), "/%s", name);
+  DebugTf("upload [%s], [%u] bytes\r\n", uploadTarget, needed);
+  
+  if (!freeSpace(needed))
   {
-    if (upload.filename.length() > 30) 
-    {
-      upload.filename = upload.filename.substring(upload.filename.length() - 30, upload.filename.length());  // Dateinamen auf 30 Zeichen kürzen
-    }
-    Debugln("FileUpload Name: " + upload.filename);
-    fsUploadFile = LittleFS.open("/" + httpServer.urlDecode(upload.filename), "w");
-  } 
-  else if (upload.status == UPLOAD_FILE_WRITE) 
+    uploadError = "507: not enough free space";
+    return;
+  }
+  uploadFile = LittleFS.open(UPLOAD_TEMP, "w");
+  if (!uploadFile) uploadError = "500: open failed";
+  
+} // uploadStart()
+
+//-------------------------------------------------------------------------------------
+static void uploadEnd(HTTPUpload& upload)
+{
+  char *end;
+  
+  uploadFlush();
+  if (uploadFile) uploadFile.close();
+  if (uploadError == NULL && httpServer.hasArg("crc"))
   {
-    Debugln("FileUpload Data: " + (String)upload.currentSize);
-    if (fsUploadFile)
-      fsUploadFile.write(upload.buf, upload.currentSize);
-  } 
-  else if (upload.status == UPLOAD_FILE_END) 
+    uint32_t crc = strtoul(httpServer.arg("crc").c_str(), &end, 16);
+    if (crc != uploadCrc) uploadError = "400: CRC does not match";
+  }
+  if (uploadError == NULL && !LittleFS.rename(UPLOAD_TEMP, uploadTarget)) uploadError = "500: rename failed";
+  
+  if (uploadError != NULL)
   {
-    if (fsUploadFile)
-      fsUploadFile.close();
-    Debugln("FileUpload Size: " + (String)upload.totalSize);
-    httpServer.sendContent(Header);
+    ErrorTf("upload [%s] failed [%s]\r\n", uploadTarget, uploadError);
+    LittleFS.remove(UPLOAD_TEMP);
+    httpServer.send(atoi(uploadError), "text/plain", uploadError);
+    return;
+  }
+  InfoTf("upload [%s] [%u] bytes, crc [%08x]\r\n", uploadTarget, upload.totalSize, uploadCrc);
+  assetChanged(uploadTarget);
+  if (strcmp(uploadTarget, SETTINGS_FILE) == 0) settingsIniChanged();
+  httpServer.sendContent(Header);
+  
+} // uploadEnd()
+
+//-------------------------------------------------------------------------------------
+void handleFileUpload() 
+{
+  HTTPUpload& upload = httpServer.upload();
+  
+  switch(upload.status)
+  {
+    case UPLOAD_FILE_START:   uploadStart(upload);
+                              break;
+    case UPLOAD_FILE_WRITE:   if (uploadError != NULL) break;
+                              uploadCrc = calcCRC32(upload.buf, upload.currentSize, uploadCrc);
+                              for (size_t pos=0; pos<upload.currentSize; )
+                              {
+                                size_t n = std::min((size_t)(UPLOAD_BUF_SIZE - uploadBufLen), upload.currentSize - pos);
+                                memcpy(&uploadBuf[uploadBufLen], &upload.buf[pos], n);
+                                uploadBufLen += n;
+                                pos          += n;
+                                if (uploadBufLen == UPLOAD_BUF_SIZE) uploadFlush();
+                              }
+                              break;
+    case UPLOAD_FILE_END:     uploadEnd(upload);
+                              break;
+    case UPLOAD_FILE_ABORTED: ErrorTf("upload [%s] aborted\r\n", uploadTarget);
+                              if (uploadFile) uploadFile.close();
+                              LittleFS.remove(UPLOAD_TEMP);
+                              break;
   }
   
 } // handleFileUpload() 
@@ -265,12 +436,12 @@ const String &contentType(String& filename)
 } // &contentType()
 
 //=====================================================================================
-bool freeSpace(uint16_t const& printsize) 
+//-- true if there is room for needed bytes and the UPLOAD_SPARE next to it
+bool freeSpace(uint32_t needed) 
 {    
-  FSInfo LittleFSinfo;
-  LittleFS.info(LittleFSinfo);
-  Debugln(formatBytes(LittleFSinfo.totalBytes - (LittleFSinfo.usedBytes * 1.05)) + " im Spiffs frei");
-  return (LittleFSinfo.totalBytes - (LittleFSinfo.usedBytes * 1.05) > printsize) ? true : false;
+  uint32_t room = platformFsTotal() - platformFsUsed();
+  DebugTf("[%u] bytes free, [%u] needed\r\n", room, needed);
+  return (room > (needed + UPLOAD_SPARE));
   
 } // freeSpace()
 
@@ -279,7 +450,11 @@ bool freeSpace(uint16_t const& printsize)
 void updateFirmware()
 {
   DebugTln(F("Redirect to updateIndex .."));
+#if defined(ESP32)
+  doRedirect("wait ... ", 1, "/update", false);   //-- the page of HTTPUpdateServer
+#else
   doRedirect("wait ... ", 1, "/updateIndex", false);
+#endif
       
 } // updateFirmware()
 
@@ -327,11 +502,6 @@ void doRedirect(String msg, int wait, const char* URL, bool reboot)
   
   DebugTln(msg);
   httpServer.send(200, "text/html", redirectHTML);
-  if (reboot) 
-  {
-    delay(5000);
-    ESP.restart();
-    delay(5000);
-  }
+  if (reboot) rebootDevice(msg.c_str());
   
 } // doRedirect()
@@ -0,0 +1,186 @@
+#include "assetStuff.h"
+
+/* 
+***************************************************************************  
+**  Program  : assetStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.                                                            
+***************************************************************************      
+*/
+
+//-- Static web files are served from LittleFS as '<path>.gz' when the build
+//-- step (gzipAssets.py) put one there, otherwise as is. Every response
+//-- has a strong ETag (CRC32 of what is sent) so a browser that already
+//-- has the file gets a '304 Not Modified' without a body.
+typedef struct _webAsset {
+  const char *uri;
+  const char *path;
+  char        eTag[ASSET_ETAG_SIZE];   // "" = not yet calculated
+} webAsset;
+
+static webAsset assets[MAX_WEB_ASSETS];
+static uint8_t  assetCount = 0;
+
+//=======================================================================
+static bool assetFile(webAsset *a, File &f, bool &isGzip)
+{
+  char gzPath[40];
+  
+  snprintf(gzPath, sizeof(gzPath), "%s.gz", a->path);
+  isGzip = LittleFS.exists(gzPath);
+  f = LittleFS.open(isGzip ? gzPath : a->path, "r");
+  return (bool)f;
+  
+} // assetFile()
+
+
+//=======================================================================
+static void calcAssetETag(webAsset *a, File &f)
+{
+  uint8_t   buff[128];
+  uint32_t  crc = 0;
+  
+  while (f.available())
+  {
+    int len = f.read(buff, sizeof(buff));
+    if (len <= 0) break;
+    crc = calcCRC32(buff, len, crc);
+  }
+  f.seek(0, SeekSet);
+  snprintf(a->eTag, sizeof(a->eTag), "\"%08x\"", crc);
+  
+} // calcAssetETag()
+
+
+//=======================================================================
+static void sendAsset(webAsset *a)
+{
+  File  f;
+  bool  isGzip;
+  
+  if (!assetFile(a, f, isGzip))
+  {
+    httpServer.send(404, "text/plain", "FileNotFound\r\n");
+    return;
+  }
+  if (a->eTag[0] == '\0') calcAssetETag(a, f);
+  
+  if (assetNotModified(a->eTag))
+  {
+    f.close();
+    return;
+  }
+  //-- streamFile() adds "Content-Encoding: gzip" for a '.gz' file
+  String path = a->path;
+  httpServer.streamFile(f, contentType(path));
+  f.close();
+  
+} // sendAsset()
+
+
+//=======================================================================
+//-- sends the validators, and the 304 if the browser's copy is current
+bool assetNotModified(const char *eTag)
+{
+  httpServer.sendHeader("ETag", eTag);
+  httpServer.sendHeader("Cache-Control", "no-cache");   // always revalidate
+  if (httpServer.header("If-None-Match") == eTag)
+  {
+    httpServer.send(304);
+    return true;
+  }
+  return false;
+  
+} // assetNotModified()
+
+
+//=======================================================================
+void serveAsset(const char *uri, const char *path)
+{
+  if (assetCount >= MAX_WEB_ASSETS)
+  {
+    ErrorTf("no room for asset [%s]!\r\n", uri);
+    return;
+  }
+  webAsset *a = &assets[assetCount++];
+  a->uri     = uri;
+  a->path    = path;
+  a->eTag[0] = '\0';
+  httpServer.on(uri, HTTP_GET, [a]() { sendAsset(a); });
+  
+} // serveAsset()
+
+
+//=======================================================================
+//-- after an upload or delete: forget the ETag and, if the plain file
+//-- itself was replaced, the '.gz' copy that is now out of date
+void assetChanged(const char *path)
+{
+  char    plain[40];
+  int     len;
+
+  strCopy(plain, sizeof(plain) -1, path);
+  len = strlen(plain);
+  bool isGzip = (len > 3 && strcmp(&plain[len-3], ".gz") == 0);
+  if (isGzip) plain[len-3] = '\0';
+
+  for (uint8_t i=0; i<assetCount; i++)
+  {
+    if (strcmp(assets[i].path, plain) != 0) continue;
+    assets[i].eTag[0] = '\0';
+    if (!isGzip)
+    {
+      snprintf(plain, sizeof(plain), "%s.gz", assets[i].path);
+      if (LittleFS.exists(plain))
+      {
+        DebugTf("remove outdated [%s]\r\n", plain);
+        LittleFS.remove(plain);
+      }
+    }
+  }
+  
+} // assetChanged()
+
+
+//=======================================================================
+void setupAssets()
+{
+  static const char *headerKeys[] = { "If-None-Match" };
+  
+  httpServer.collectHeaders(headerKeys, 1);
+  
+  serveAsset("/index.css",       "/index.css");
+  serveAsset("/index.js",        "/index.js");
+  serveAsset("/FSexplorer.css",  "/FSexplorer.css");
+  serveAsset("/FSexplorer.png",  "/FSexplorer.png");
+  serveAsset("/settings.png",    "/settings.png");
+  serveAsset("/favicon.ico",     "/favicon.ico");
+  
+} // setupAssets()
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* 
+****************************************************************************
+*/
@@ -0,0 +1,693 @@
+#include "fetchStuff.h"
+#include "trustAnchors.h"
+
+/* 
+***************************************************************************  
+**  Program  : fetchStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.                                                            
+***************************************************************************      
+*/
+
+//-- One upstream fetch at a time, moved forward a bit on every pass
+//-- of loop() so the display and the webserver keep running:
+//--    connect -> send -> headers -> body (handed to the provider)
+//-- A (chunked) body is passed to the provider's handler as it comes in.
+//-- Port FETCH_HTTPS_PORT is fetched with BearSSL (mbedTLS on the ESP32),
+//-- the certificate of the host is checked against the root certificates
+//-- of trustAnchors.h (fails closed: no clock, no connection). The TLS
+//-- session of every host is kept so the next connect is an (abbreviated)
+//-- resumed handshake (not on the ESP32, its WiFiClientSecure can not),
+//-- the resolved address is kept for FETCH_DNS_TTL and a
+//-- connection the server allows to stay open is used again by the next
+//-- fetch from the same host (the retry after a failure for instance).
+
+#define CHUNK_SIZE_LINE   0
+#define CHUNK_DATA        1
+#define CHUNK_DATA_END    2
+#define CHUNK_TRAILER     3
+
+static const char *providerName[FETCH_PROVIDERS] = { "weerlive", "newsapi" };
+
+#if defined(ESP32)
+  //-- WiFiClient::setTimeout() of the ESP32 core is in seconds
+  #define FETCH_TIMEOUT_ARG   (FETCH_CONNECT_TIMEOUT / 1000)
+#else
+  #define FETCH_TIMEOUT_ARG   FETCH_CONNECT_TIMEOUT
+#endif
+
+//-- connect to the cached address of a host but hand the name to TLS: it
+//-- is the SNI and the name the certificate has to be for
+#if defined(ESP32)
+class fetchTlsClient : public WiFiClientSecure {
+  public:
+    int connectTo(IPAddress ip, uint16_t port, const char *name, const char *rootCA)
+    {
+      return connect(ip, port, name, rootCA, NULL, NULL);
+    }
+};
+#else
+class fetchTlsClient : public BearSSL::WiFiClientSecureCtx {
+  public:
+    int connectTo(IPAddress ip, uint16_t port, const char *name)
+    {
+      if (!WiFiClient::connect(ip, port)) return 0;
+      return _connectSSL(name);
+    }
+};
+#endif
+
+static WiFiClient                 plainClient;
+static fetchTlsClient             secureClient;
+#if defined(ESP32)
+static char                      *anchorsFile   = NULL;   // TRUST_ANCHORS_FILE, only while connected
+#else
+static BearSSL::X509List         *trustAnchors  = NULL;   // only while connected
+static BearSSL::Session           hostSession[FETCH_HOSTS];
+#endif
+static fetchHostStats             hostStat[FETCH_HOSTS];   // one host per provider
+static WiFiClient      *fetchClient   = NULL;   // &plainClient, &secureClient or not connected
+static uint8_t          connProvider;           // fetchClient is connected to its host
+static bool             connSecure;
+static uint32_t         connIdleSince;
+static bool             fetchSecure;
+static bool             fetchReused;
+static bool             fetchKeepAlive;         // server did not send "Connection: close"
+static bool             fetchBodyDone;          // all of the body is read
+static fetchStats       fetchStat[FETCH_PROVIDERS];
+static uint8_t          fetchState    = FETCH_IDLE;
+static uint8_t          fetchProvider;
+static const char      *fetchHost;
+static uint16_t         fetchPort;
+static char             fetchPath[FETCH_PATH_MAX];
+static fetchBodyHandler fetchOnBody;
+static fetchDoneHandler fetchOnDone;
+static uint32_t         fetchProgress;              // millis() of last progress
+
+static char             fetchLine[FETCH_LINE_MAX];  // current header line
+static uint8_t          fetchLineLen;
+static bool             fetchFirstLine;
+static bool             fetchChunked;
+static int32_t          fetchContentLength;         // -1 = unknown
+static uint8_t          chunkState;
+static uint32_t         chunkRemaining;
+static bool             chunkSizeDone;              // rest of size line is ignored
+static char             fetchBuff[NET_CHUNK_SIZE];
+
+
+//=======================================================================
+bool fetchStart(uint8_t provider, const char *host, uint16_t port, const char *path
+                                , fetchBodyHandler onBody, fetchDoneHandler onDone)
+{
+  if (fetchState != FETCH_IDLE || provider >= FETCH_PROVIDERS) return false;
+  
+  fetchProvider       = provider;
+  fetchHost           = host;
+  fetchPort           = port;
+  strCopy(fetchPath, sizeof(fetchPath), path, 0, sizeof(fetchPath) -2);
+  fetchOnBody         = onBody;
+  fetchOnDone         = onDone;
+  fetchLineLen        = 0;
+  fetchFirstLine      = true;
+  fetchChunked        = false;
+  fetchContentLength  = -1;
+  fetchSecure         = (port == FETCH_HTTPS_PORT);
+  fetchKeepAlive      = true;
+  fetchBodyDone       = false;
+  chunkState          = CHUNK_SIZE_LINE;
+  chunkRemaining      = 0;
+  chunkSizeDone       = false;
+
+  fetchStat[provider].httpStatus = 0;
+  fetchStat[provider].bodyBytes  = 0;
+  fetchStat[provider].startTime  = millis();
+  fetchProgress = millis();
+  fetchState    = FETCH_CONNECT;
+  DebugTf("start fetch [%s] from [%s]\r\n", providerName[provider], host);
+  return true;
+  
+} // fetchStart()
+
+
+//=======================================================================
+bool fetchBusy()
+{
+  return (fetchState != FETCH_IDLE);
+  
+} // fetchBusy()
+
+
+//=======================================================================
+const fetchStats *fetchGetStats(uint8_t provider)
+{
+  if (provider >= FETCH_PROVIDERS) return NULL;
+  return &fetchStat[provider];
+  
+} // fetchGetStats()
+
+
+//=======================================================================
+const char *fetchProviderName(uint8_t provider)
+{
+  if (provider >= FETCH_PROVIDERS) return "unknown";
+  return providerName[provider];
+  
+} // fetchProviderName()
+
+
+//=======================================================================
+const fetchHostStats *fetchGetHost(uint8_t h)
+{
+  if (h >= FETCH_HOSTS || hostStat[h].name == NULL) return NULL;
+  return &hostStat[h];
+  
+} // fetchGetHost()
+
+
+//=======================================================================
+static void fetchClose()
+{
+  if (fetchClient == NULL) return;
+  fetchClient->stop();
+  fetchClient = NULL;
+#if defined(ESP32)
+  free(anchorsFile);
+  anchorsFile = NULL;
+#else
+  if (trustAnchors != NULL)
+  {
+    delete trustAnchors;
+    trustAnchors = NULL;
+  }
+#endif
+  
+} // fetchClose()
+
+
+//=======================================================================
+//-- the root certificates (PEM), from TRUST_ANCHORS_FILE if there is one
+#if defined(ESP32)
+static const char *fetchLoadAnchors()
+{
+  File file = LittleFS.open(TRUST_ANCHORS_FILE, "r");
+  
+  if (file)
+  {
+    size_t len = file.size();
+    anchorsFile = (char*)malloc(len +1);
+    if (anchorsFile != NULL) anchorsFile[file.read((uint8_t*)anchorsFile, len)] = '\0';
+    file.close();
+    if (anchorsFile != NULL && strstr(anchorsFile, "-----BEGIN CERTIFICATE-----") == NULL)
+    {
+      ErrorTf("no certificates in [%s], the built in ones are used\r\n", TRUST_ANCHORS_FILE);
+      free(anchorsFile);
+      anchorsFile = NULL;
+    }
+  }
+  return (anchorsFile != NULL) ? anchorsFile : trustAnchorsPem;
+  
+} // fetchLoadAnchors()
+#else
+static BearSSL::X509List *fetchLoadAnchors()
+{
+  BearSSL::X509List *anchors = NULL;
+  File               file    = LittleFS.open(TRUST_ANCHORS_FILE, "r");
+  
+  if (file)
+  {
+    size_t  len = file.size();
+    char   *pem = (char*)malloc(len +1);
+    if (pem != NULL)
+    {
+      pem[file.read((uint8_t*)pem, len)] = '\0';
+      anchors = new BearSSL::X509List(pem);
+      free(pem);
+    }
+    file.close();
+    if (anchors != NULL && anchors->getCount() == 0)
+    {
+      ErrorTf("no certificates in [%s], the built in ones are used\r\n", TRUST_ANCHORS_FILE);
+      delete anchors;
+      anchors = NULL;
+    }
+  }
+  if (anchors == NULL) anchors = new BearSSL::X509List(trustAnchorsPem);
+  return anchors;
+  
+} // fetchLoadAnchors()
+#endif
+
+
+#if !defined(ESP32)
+//=======================================================================
+//-- a host in TLS_NO_MFLN_FILE refused max fragment length before
+static bool fetchMflnRefused(const char *name)
+{
+  File  file = LittleFS.open(TLS_NO_MFLN_FILE, "r");
+  char  line[FETCH_LINE_MAX];
+  bool  found = false;
+  
+  if (!file) return false;
+  while (!found && file.available())
+  {
+    int len = file.readBytesUntil('\n', line, sizeof(line) -1);
+    line[len] = '\0';
+    found = (strcmp(line, name) == 0);
+  }
+  file.close();
+  return found;
+  
+} // fetchMflnRefused()
+
+
+//=======================================================================
+static void fetchMflnRemember(const char *name)
+{
+  File file = LittleFS.open(TLS_NO_MFLN_FILE, "a");
+  
+  if (!file) return;
+  file.print(name);
+  file.print('\n');
+  file.close();
+  
+} // fetchMflnRemember()
+#endif
+
+
+//=======================================================================
+//-- a connection to the same host that is still open
+static bool fetchReuse()
+{
+  if (fetchClient == NULL || connProvider != fetchProvider || connSecure != fetchSecure) return false;
+  if (!fetchClient->connected() || fetchClient->available() > 0)
+  {
+    fetchClose();
+    return false;
+  }
+  hostStat[fetchProvider].reuses++;
+  return true;
+  
+} // fetchReuse()
+
+
+//=======================================================================
+static bool fetchResolve()
+{
+  fetchHostStats *host  = &hostStat[fetchProvider];
+  uint32_t        start = millis();
+  
+  if (host->name != fetchHost)
+  {
+    //-- another host for this provider, forget the old one
+    *host = fetchHostStats();
+    host->name = fetchHost;
+#if !defined(ESP32)
+    hostSession[fetchProvider] = BearSSL::Session();
+#endif
+  }
+#if !defined(ESP32)
+  if (fetchSecure && host->mfln == 0 && fetchMflnRefused(fetchHost)) host->mfln = 2;
+#endif
+  if (host->resolvedAt != 0 && (millis() - host->resolvedAt) < FETCH_DNS_TTL) return true;
+  
+#if defined(ESP32)
+  if (!WiFi.hostByName(fetchHost, host->ip))
+#else
+  if (!WiFi.hostByName(fetchHost, host->ip, FETCH_CONNECT_TIMEOUT))
+#endif
+  {
+    ErrorTf("DNS lookup of [%s] failed\r\n", fetchHost);
+    return false;
+  }
+  host->dnsMs      = millis() - start;
+  host->resolvedAt = millis() | 1;
+  DebugTf("[%s] is [%s] (%u ms)\r\n", fetchHost, host->ip.toString().c_str(), host->dnsMs);
+  return true;
+  
+} // fetchResolve()
+
+
+//=======================================================================
+//-- the only step that waits, in a pass of loop() of its own: at most
+//-- FETCH_CONNECT_TIMEOUT ms, a full TLS handshake takes a second or two,
+//-- a resumed one a fraction of it
+static bool fetchConnect()
+{
+  fetchHostStats *host  = &hostStat[fetchProvider];
+  uint32_t        start = millis();
+  bool            ok;
+  
+  fetchClose();
+  if (fetchSecure)
+  {
+    time_t now = time(nullptr);
+    if (now < FETCH_CLOCK_VALID)
+    {
+      ErrorTf("no time yet, the certificate of [%s] can not be checked\r\n", fetchHost);
+      host->certFails++;
+      return false;
+    }
+#if defined(ESP32)
+    //-- mbedTLS checks the dates against time() itself, its buffers are
+    //-- fixed by the core (no max fragment length)
+    secureClient.setTimeout(FETCH_TIMEOUT_ARG);
+    secureClient.setHandshakeTimeout(FETCH_TIMEOUT_ARG);
+    fetchClient = &secureClient;
+    ok = secureClient.connectTo(host->ip, fetchPort, fetchHost, fetchLoadAnchors());
+    if (!ok)
+    {
+      char reason[64];
+      secureClient.lastError(reason, sizeof(reason));
+      ErrorTf("TLS connect to [%s] failed: %s\r\n", fetchHost, reason);
+      host->certFails++;
+    }
+#else
+    //-- a small receive buffer makes BearSSL ask for max fragment length
+    if (host->mfln == 2)  secureClient.setBufferSizes(FETCH_TLS_RX_FALLBACK, 512);
+    else                  secureClient.setBufferSizes(FETCH_TLS_RX_SIZE, 512);
+    trustAnchors = fetchLoadAnchors();
+    secureClient.setTrustAnchors(trustAnchors);
+    secureClient.setX509Time(now);
+    secureClient.setSession(&hostSession[fetchProvider]);
+    secureClient.setTimeout(FETCH_TIMEOUT_ARG);
+    fetchClient = &secureClient;
+    ok = secureClient.connectTo(host->ip, fetchPort, fetchHost);
+    if (host->mfln == 0 && (ok || secureClient.getLastSSLError() == BR_ERR_TOO_LARGE))
+    {
+      //-- it is only known after a handshake, the next connect uses it
+      host->mfln = (ok && secureClient.getMFLNStatus()) ? 1 : 2;
+      if (host->mfln == 2)
+      {
+        InfoTf("[%s] refused max fragment length, rx buffer [%d]\r\n", fetchHost, FETCH_TLS_RX_FALLBACK);
+        fetchMflnRemember(fetchHost);
+      }
+    }
+    if (!ok)
+    {
+      char reason[64];
+      secureClient.getLastSSLError(reason, sizeof(reason));
+      ErrorTf("TLS connect to [%s] failed: %s\r\n", fetchHost, reason);
+      host->certFails++;
+    }
+#endif
+  }
+  else
+  {
+    plainClient.setTimeout(FETCH_TIMEOUT_ARG);
+    ok = plainClient.connect(host->ip, fetchPort);
+    fetchClient = &plainClient;
+  }
+  host->connectMs = millis() - start;
+  if (host->connectMs > host->maxConnectMs) host->maxConnectMs = host->connectMs;
+  if (!ok)
+  {
+    host->connectFails++;
+    host->resolvedAt = 0;     //-- maybe the address changed
+    fetchClose();
+    return false;
+  }
+  host->connects++;
+  connProvider = fetchProvider;
+  connSecure   = fetchSecure;
+  DebugTf("connected to [%s:%d] in [%u]ms\r\n", fetchHost, fetchPort, host->connectMs);
+  return true;
+  
+} // fetchConnect()
+
+
+//=======================================================================
+static void fetchFinish(bool ok)
+{
+  fetchStats *stat = &fetchStat[fetchProvider];
+  
+  if (ok && fetchBodyDone && fetchKeepAlive)  connIdleSince = millis();
+  else                                        fetchClose();
+  fetchState     = FETCH_IDLE;
+  stat->duration = millis() - stat->startTime;
+  if (ok) stat->okCount++;
+  else    stat->failCount++;
+  metricsFetchDone(fetchProvider, stat->duration, ok);
+  DebugTf("fetch [%s] %s status[%d] [%u]bytes in [%u]ms\r\n", providerName[fetchProvider]
+                                                     , (ok ? "OK" : "FAILED")
+                                                     , stat->httpStatus
+                                                     , stat->bodyBytes
+                                                     , stat->duration);
+  if (fetchOnDone != NULL) fetchOnDone(ok);
+  
+} // fetchFinish()
+
+
+//=======================================================================
+static void processHeaderLine()
+{
+  fetchLine[fetchLineLen] = '\0';
+  if (fetchFirstLine)
+  {
+    //-- "HTTP/1.1 200 OK"
+    fetchFirstLine = false;
+    char *sp = strchr(fetchLine, ' ');
+    if (strncmp(fetchLine, "HTTP/", 5) == 0 && sp != NULL)
+    {
+      fetchStat[fetchProvider].httpStatus = atoi(sp +1);
+    }
+    return;
+  }
+  if (strncasecmp(fetchLine, "Content-Length:", 15) == 0)
+  {
+    fetchContentLength = atol(&fetchLine[15]);
+  }
+  else if (strncasecmp(fetchLine, "Connection:", 11) == 0)
+  {
+    strToLower(fetchLine);
+    fetchKeepAlive = (strstr(fetchLine, "close") == NULL);
+  }
+  else if (strncasecmp(fetchLine, "Transfer-Encoding:", 18) == 0)
+  {
+    strToLower(fetchLine);
+    fetchChunked = (strstr(fetchLine, "chunked") != NULL);
+  }
+  
+} // processHeaderLine()
+
+
+//=======================================================================
+//-- hand a piece of payload to the provider, false if it is done
+static bool deliverBody(const char *data, int len)
+{
+  if (len <= 0) return true;
+  fetchStat[fetchProvider].bodyBytes += len;
+  return fetchOnBody(data, len);
+  
+} // deliverBody()
+
+
+//=======================================================================
+//-- returns false when the body is complete (or no longer wanted)
+static bool processBody(const char *data, int len)
+{
+  if (!fetchChunked) 
+  {
+    if (!deliverBody(data, len)) return false;
+    fetchBodyDone = (fetchContentLength >= 0
+              && fetchStat[fetchProvider].bodyBytes >= (uint32_t)fetchContentLength);
+    return !fetchBodyDone;
+  }
+
+  int i = 0;
+  while (i < len)
+  {
+    switch(chunkState)
+    {
+      case CHUNK_SIZE_LINE: 
+      case CHUNK_TRAILER:
+              {
+                char c = data[i++];
+                if (c == '\n')
+                {
+                  if (chunkState == CHUNK_TRAILER)
+                  {
+                    fetchBodyDone = true;
+                    return false;
+                  }
+                  chunkState = (chunkRemaining == 0) ? CHUNK_TRAILER : CHUNK_DATA;
+                }
+                else if (chunkState == CHUNK_SIZE_LINE && !chunkSizeDone)
+                {
+                  if      (c >= '0' && c <= '9') chunkRemaining = (chunkRemaining << 4) | (c - '0');
+                  else if (c >= 'a' && c <= 'f') chunkRemaining = (chunkRemaining << 4) | (c - 'a' + 10);
+                  else if (c >= 'A' && c <= 'F') chunkRemaining = (chunkRemaining << 4) | (c - 'A' + 10);
+                  else    chunkSizeDone = true;  // chunk extension or '\r'
+                }
+              }
+              break;
+      case CHUNK_DATA:
+              {
+                int span = len - i;
+                if ((uint32_t)span > chunkRemaining) span = chunkRemaining;
+                if (!deliverBody(&data[i], span)) return false;
+                i += span;
+                chunkRemaining -= span;
+                if (chunkRemaining == 0) chunkState = CHUNK_DATA_END;
+              }
+              break;
+      case CHUNK_DATA_END:
+              if (data[i++] == '\n')
+              {
+                chunkState    = CHUNK_SIZE_LINE;
+                chunkSizeDone = false;
+              }
+              break;
+    }
+  }
+  return true;
+  
+} // processBody()
+
+
+//=======================================================================
+void fetchLoop()
+{
+  char request[FETCH_PATH_MAX + 100];
+  int  avail;
+  
+  if (fetchState == FETCH_IDLE) 
+  {
+    //-- close a kept-alive connection that is no longer useful
+    if (fetchClient != NULL && (((millis() - connIdleSince) > FETCH_KEEPALIVE) 
+                                || !fetchClient->connected()))
+    {
+      fetchClose();
+    }
+    return;
+  }
+
+  if ((millis() - fetchProgress) > FETCH_TIMEOUT)
+  {
+    DebugTf("fetch [%s] timeout in state[%d]\r\n", providerName[fetchProvider], fetchState);
+    fetchFinish(false);
+    return;
+  }
+
+  switch(fetchState)
+  {
+    case FETCH_CONNECT:
+            fetchReused = fetchReuse();
+            if (!fetchReused && !fetchResolve())
+            {
+              fetchFinish(false);
+              return;
+            }
+            fetchProgress = millis();
+            fetchState    = (fetchReused ? FETCH_SEND : FETCH_HANDSHAKE);
+            break;
+            
+    case FETCH_HANDSHAKE:
+            if (!fetchConnect())
+            {
+              ErrorTf("connection to [%s] failed\r\n", fetchHost);
+              fetchFinish(false);
+              return;
+            }
+            fetchProgress = millis();
+            fetchState    = FETCH_SEND;
+            break;
+            
+    case FETCH_SEND:
+            snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\n"
+                                               "Host: %s\r\n"
+                                               "User-Agent: ESP-ticker\r\n"
+                                               "Connection: keep-alive\r\n\r\n"
+                                              , fetchPath, fetchHost);
+            fetchClient->write((const uint8_t*)request, strlen(request));
+            fetchProgress = millis();
+            fetchState    = FETCH_HEADERS;
+            break;
+            
+    case FETCH_HEADERS:
+            avail = fetchClient->available();
+            if (avail <= 0)
+            {
+              if (fetchClient->connected()) return;
+              if (fetchReused && fetchFirstLine && fetchLineLen == 0)
+              {
+                //-- the server closed the kept connection, once more with a new one
+                DebugTf("[%s] closed the connection, reconnect\r\n", fetchHost);
+                fetchClose();
+                fetchReused = false;
+                fetchState  = FETCH_HANDSHAKE;
+                return;
+              }
+              fetchFinish(false);
+              return;
+            }
+            if (avail > NET_CHUNK_SIZE) avail = NET_CHUNK_SIZE;
+            fetchProgress = millis();
+            for (int i=0; i<avail; i++)
+            {
+              char c = fetchClient->read();
+              if (c == '\r') continue;
+              if (c != '\n')
+              {
+                if (fetchLineLen < (FETCH_LINE_MAX -1)) fetchLine[fetchLineLen++] = c;
+                continue;
+              }
+              if (fetchLineLen > 0)
+              {
+                processHeaderLine();
+                fetchLineLen = 0;
+                continue;
+              }
+              //-- empty line: end of headers
+              if (fetchStat[fetchProvider].httpStatus != 200)
+              {
+                fetchFinish(false);
+                return;
+              }
+              fetchState = FETCH_BODY;
+              break;
+            }
+            break;
+            
+    case FETCH_BODY:
+            avail = fetchClient->available();
+            if (avail <= 0)
+            {
+              //-- no length or chunking, so end of data is end of body
+              if (!fetchClient->connected()) fetchFinish(!fetchChunked && fetchContentLength < 0);
+              return;
+            }
+            if (avail > (int)sizeof(fetchBuff)) avail = sizeof(fetchBuff);
+            avail = fetchClient->read((uint8_t*)fetchBuff, avail);
+            fetchProgress = millis();
+            if (!processBody(fetchBuff, avail)) fetchFinish(true);
+            break;
+  }
+  
+} // fetchLoop()
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* 
+****************************************************************************
+*/
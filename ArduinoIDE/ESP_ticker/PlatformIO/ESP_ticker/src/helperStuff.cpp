@@ -344,7 +344,7 @@ void strTrimCntr(char *dest, int maxLen)
 int strIndex(const char *haystack, const char *needle, int start)
 {
   // strindex(hay, needle) ????
-  char *p = strstr(haystack+start, needle);
+  const char *p = strstr(haystack+start, needle);
   if (p) {
     //DebugTf("found [%s] at position [%d]\r\n", needle, (p - haystack));
     return (p - haystack);
@@ -418,93 +418,100 @@ float strToFloat(const char *s, int dec)
 } //  strToFloat()
 
 //===========================================================================================
-void parseJsonKey(const char *sIn, const char *key, char *val, int valLen)
+// Windows-1252 codes 0x80..0x9F and their Unicode code point (0 = not used).
+// All other codes 0xA0..0xFF are the same in ISO-8859-1 (Latin-1) and Unicode
+static const uint16_t cp1252High[32] = {
+  0x20AC, 0,      0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,   // 0x80
+  0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0,      0x017D, 0,        // 0x88
+  0,      0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,   // 0x90
+  0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0,      0x017E, 0x0178    // 0x98
+};
+
+//===========================================================================================
+// Unicode code point of a Windows-1252 (display) character
+uint16_t latin1ToUnicode(uint8_t c)
 {
-  // json key-value pair looks like:
-  //      "samenv": "Zwaar bewolkt",
-  // or   "samenv": "Zwaar bewolkt"}
-  int keyStart   = strIndex(sIn, key);
-  int sepStart   = strIndex(sIn, ",", keyStart);
-  if (sepStart == -1) 
-  {
-    sepStart   = strIndex(sIn, "}", keyStart);
-  }
-  strCopy(val, valLen, sIn, keyStart+strlen(key), sepStart);
-  strRemoveAll(val, valLen, ':');
-  strRemoveAll(val, valLen, ',');
-  strRemoveAll(val, valLen, '}');
-  strRemoveAll(val, valLen, '"');
-  strTrim(val, valLen, ' ');
+  if (c >= 0x80 && c < 0xA0) return cp1252High[c - 0x80];
+  return c;
   
-} // parseJsonKey()
+} // latin1ToUnicode()
 
 //===========================================================================================
-uint8_t utf8Ascii(uint8_t ascii)
-// Convert a single Character from UTF8 to Extended ASCII according to ISO 8859-1,
-// also called ISO Latin-1. Codes 128-159 contain the Microsoft Windows Latin-1
-// extended characters:
-// - codes 0..127 are identical in ASCII and UTF-8
-// - codes 160..191 in ISO-8859-1 and Windows-1252 are two-byte characters in UTF-8
-//                 + 0xC2 then second byte identical to the extended ASCII code.
-// - codes 192..255 in ISO-8859-1 and Windows-1252 are two-byte characters in UTF-8
-//                 + 0xC3 then second byte differs only in the first two bits to extended ASCII code.
-// - codes 128..159 in Windows-1252 are different, but usually only the €-symbol will be needed from this range.
-//                 + The euro symbol is 0x80 in Windows-1252, 0xa4 in ISO-8859-15, and 0xe2 0x82 0xac in UTF-8.
-//
-// Modified from original code at http://playground.arduino.cc/Main/Utf8ascii
-// Extended ASCII encoding should match the characters at http://www.ascii-code.com/
-//
-// Return "0" if a byte has to be ignored.
+// Windows-1252 character for a Unicode code point, '?' if there is none
+static uint8_t unicodeToLatin1(uint32_t cp)
 {
-  static uint8_t cPrev;
-  uint8_t c = '\0';
-
-  if (ascii < 0x7f)   // Standard ASCII-set 0..0x7F, no conversion
+  if (cp < 0x80 || (cp >= 0xA0 && cp <= 0xFF)) return cp;
+  for (uint8_t i=0; i<32; i++)
   {
-    cPrev = '\0';
-    c = ascii;
+    if (cp1252High[i] == cp) return 0x80 + i;
   }
-  else
+  return '?';
+  
+} // unicodeToLatin1()
+
+//===========================================================================================
+// In place conversion of an UTF-8 string to Windows-1252 (a superset of
+// ISO-8859-1) as used by the ExtASCII display font. The result is never
+// longer than the input. A byte that does not start a valid UTF-8 sequence
+// is taken to be Windows-1252 already, so converting twice does no harm.
+// Returns the new length.
+int utf8ToLatin1(char *s)
+{
+  const uint8_t *in  = (const uint8_t*)s;
+  uint8_t       *out = (uint8_t*)s;
+  
+  while (*in)
   {
-    switch (cPrev)  // Conversion depending on preceding UTF8-character
+    uint8_t   c     = *in;
+    uint8_t   more  = (c >= 0xF0 && c < 0xF5) ? 3 : (c >= 0xE0) && (c < 0xF0) ? 2 : (c >= 0xC2 && c < 0xE0) ? 1 : 0;
+    uint32_t  cp    = (more == 3) ? (c & 0x07) : (more == 2) ? (c & 0x0F) : (c & 0x1F);
+    uint8_t   n;
+
+    for (n = 1; n <= more; n++)
+    {
+      if ((in[n] & 0xC0) != 0x80) break;    // also stops at the '\0'
+      cp = (cp << 6) | (in[n] & 0x3F);
+    }
+    if (c < 0x80 || more == 0 || n <= more)
     {
-    case 0xC2: c = ascii;  break;
-    case 0xC3: c = ascii | 0xC0;  break;
-    case 0x82: if (ascii==0xAC) c = 0x80; // Euro symbol special case
+      *out++ = c;                           // ASCII or not UTF-8
+      in++;
+      continue;
     }
-    cPrev = ascii;   // save last char
+    in += (more +1);
+    if (cp >= 0x80 && cp < 0xA0) continue;  // C1 control, drop
+    *out++ = unicodeToLatin1(cp);
   }
-  //Debugf("\nConverted 0x%02x", ascii);
-  //Debugf(" to 0x%02x", c);
+  *out = '\0';
+  return (out - (uint8_t*)s);
+
+} // utf8ToLatin1()
 
-  return(c);
-  
-} // utf8Ascii(uint8_t)
 
 //===========================================================================================
-void utf8Ascii(char* s)
-// In place conversion UTF-8 string to Extended ASCII
-// The extended ASCII string is always shorter.
+// CRC-32 (IEEE, reflected 0xEDB88320) without a lookup table.
+// Pass the result of a previous call as 'crc' to continue a running CRC
+uint32_t calcCRC32(const void *data, size_t len, uint32_t crc)
 {
-  uint8_t c;
-  char *cp = s;
+  const uint8_t *p = (const uint8_t*)data;
 
-  //DebugTf("\nConverting: %c", s);
-
-  while (*s != '\0')
+  crc = ~crc;
+  while (len--)
   {
-    c = utf8Ascii(*s++);
-    if (c != '\0')
-      *cp++ = c;
+    crc ^= *p++;
+    for (int b=0; b<8; b++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
   }
-  *cp = '\0';   // terminate the new string
-
-} // utf8Ascii(char)
+  return ~crc;
+  
+} // calcCRC32()
 
 
 void getRevisionData() 
 {
-  if (!LittleFS.exists("/newsFiles/LCL-000"))
+  if (!hasMessage("LCL", 0))
   {
     char LCL000[100];
     sprintf(LCL000, "ESP_ticker %s (c) by Willem Aandewiel", String(_FW_VERSION).c_str());
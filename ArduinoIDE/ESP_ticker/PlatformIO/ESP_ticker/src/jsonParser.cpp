@@ -0,0 +1,308 @@
+#include "jsonParser.h"
+
+/* 
+***************************************************************************  
+**  Program  : jsonParser, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.                                                            
+***************************************************************************      
+*/
+
+//-- A small streaming JSON scanner. Data is fed in chunks as it comes in
+//-- from the network; every key/value pair is reported once through the
+//-- event handler, so nothing but the current key and value is buffered.
+
+#define JS_IDLE       0
+#define JS_STRING     1
+#define JS_ESCAPE     2
+#define JS_UNICODE    3
+#define JS_SCALAR     4
+
+//=======================================================================
+void jsonScanBegin(jsonScanner *js, char *valBuff, uint16_t valMax, jsonEventHandler onEvent)
+{
+  memset(js, 0, sizeof(jsonScanner));
+  js->val     = valBuff;
+  js->valMax  = valMax;
+  js->onEvent = onEvent;
+  js->val[0]  = '\0';
+  
+} // jsonScanBegin()
+
+
+//=======================================================================
+static bool topIsObject(jsonScanner *js)
+{
+  if (js->depth == 0 || js->depth > 32) return false;
+  return (js->objStack >> (js->depth -1)) & 1;
+  
+} // topIsObject()
+
+
+//=======================================================================
+static void emitEvent(jsonScanner *js, uint8_t event)
+{
+  if (js->onEvent != NULL && !js->onEvent(js, event))
+  {
+    js->stopped = true;
+  }
+  
+} // emitEvent()
+
+
+//=======================================================================
+static void putChar(jsonScanner *js, char c)
+{
+  if (js->inKey)
+  {
+    if (js->keyLen < (JSON_KEY_MAX -1))   js->key[js->keyLen++] = c;
+    else                                  js->keyLen = 0xFF;  // too long, never matches
+    return;
+  }
+  if (js->valLen < (js->valMax -1))       js->val[js->valLen++] = c;
+  else                                    js->truncated = true;
+  
+} // putChar()
+
+
+//=======================================================================
+static void putUtf8(jsonScanner *js, uint32_t cp)
+{
+  if (cp < 0x80)
+  {
+    putChar(js, cp);
+  }
+  else if (cp < 0x800)
+  {
+    putChar(js, 0xC0 | (cp >> 6));
+    putChar(js, 0x80 | (cp & 0x3F));
+  }
+  else if (cp < 0x10000)
+  {
+    putChar(js, 0xE0 | (cp >> 12));
+    putChar(js, 0x80 | ((cp >> 6) & 0x3F));
+    putChar(js, 0x80 | (cp & 0x3F));
+  }
+  else
+  {
+    putChar(js, 0xF0 | (cp >> 18));
+    putChar(js, 0x80 | ((cp >> 12) & 0x3F));
+    putChar(js, 0x80 | ((cp >>  6) & 0x3F));
+    putChar(js, 0x80 | (cp & 0x3F));
+  }
+  
+} // putUtf8()
+
+
+//=======================================================================
+//-- a lone high surrogate is replaced by a '?'
+static void flushSurrogate(jsonScanner *js)
+{
+  if (js->hiSurrogate == 0) return;
+  js->hiSurrogate = 0;
+  putChar(js, '?');
+  
+} // flushSurrogate()
+
+
+//=======================================================================
+static void putCodePoint(jsonScanner *js, uint16_t code)
+{
+  if (code >= 0xD800 && code <= 0xDBFF)
+  {
+    flushSurrogate(js);
+    js->hiSurrogate = code;
+    return;
+  }
+  if (code >= 0xDC00 && code <= 0xDFFF)
+  {
+    if (js->hiSurrogate == 0)
+    {
+      putChar(js, '?');
+      return;
+    }
+    uint32_t cp = 0x10000 + ((uint32_t)(js->hiSurrogate - 0xD800) << 10) + (code - 0xDC00);
+    js->hiSurrogate = 0;
+    putUtf8(js, cp);
+    return;
+  }
+  flushSurrogate(js);
+  putUtf8(js, code);
+  
+} // putCodePoint()
+
+
+//=======================================================================
+static void endValue(jsonScanner *js, bool isString)
+{
+  js->val[js->valLen] = '\0';
+  js->isString  = isString;
+  js->expectKey = false;
+  emitEvent(js, JSON_EV_VALUE);
+  js->valLen    = 0;
+  js->truncated = false;
+  js->val[0]    = '\0';
+  
+} // endValue()
+
+
+//=======================================================================
+static void scanIdle(jsonScanner *js, char c)
+{
+  switch(c)
+  {
+    case '{': if (js->depth < 32) js->objStack |= ((uint32_t)1 << js->depth);
+              js->depth++;
+              js->expectKey = true;
+              emitEvent(js, JSON_EV_OBJECT_START);
+              break;
+    case '[': if (js->depth < 32) js->objStack &= ~((uint32_t)1 << js->depth);
+              js->depth++;
+              js->expectKey = false;
+              break;
+    case '}': 
+    case ']': if (js->depth > 0)
+              {
+                bool wasObject = topIsObject(js);
+                js->depth--;
+                if (wasObject) emitEvent(js, JSON_EV_OBJECT_END);
+              }
+              js->expectKey = false;
+              break;
+    case ':': js->expectKey = false;
+              break;
+    case ',': js->expectKey = topIsObject(js);
+              break;
+    case '"': js->inKey = (js->expectKey && topIsObject(js));
+              if (js->inKey) js->keyLen = 0;
+              else           js->valLen = 0;
+              js->hiSurrogate = 0;
+              js->state = JS_STRING;
+              break;
+    case ' ': 
+    case '\t':
+    case '\r':
+    case '\n':
+              break;
+    default:  //-- numbers, true, false and null
+              if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-')
+              {
+                js->inKey  = false;
+                js->valLen = 0;
+                putChar(js, c);
+                js->state  = JS_SCALAR;
+              }
+              //-- anything else is not JSON and is skipped
+  }
+  
+} // scanIdle()
+
+
+//=======================================================================
+bool jsonScanFeed(jsonScanner *js, const char *data, int len)
+{
+  for (int i=0; (i<len && !js->stopped); i++)
+  {
+    char c = data[i];
+    switch(js->state)
+    {
+      case JS_IDLE:     scanIdle(js, c);
+                        break;
+                        
+      case JS_STRING:   if (c == '"')
+                        {
+                          flushSurrogate(js);
+                          js->state = JS_IDLE;
+                          if (js->inKey)
+                          {
+                            if (js->keyLen > (JSON_KEY_MAX -1)) js->keyLen = 0;
+                            js->key[js->keyLen] = '\0';
+                            js->inKey     = false;
+                            js->expectKey = false;
+                          }
+                          else endValue(js, true);
+                        }
+                        else if (c == '\\') 
+                        {
+                          js->state = JS_ESCAPE;
+                        }
+                        else
+                        {
+                          flushSurrogate(js);
+                          putChar(js, c);
+                        }
+                        break;
+                        
+      case JS_ESCAPE:   js->state = JS_STRING;
+                        if (c != 'u') flushSurrogate(js);
+                        switch(c)
+                        {
+                          case 'n': putChar(js, '\n'); break;
+                          case 't': putChar(js, '\t'); break;
+                          case 'r': putChar(js, '\r'); break;
+                          case 'b': putChar(js, '\b'); break;
+                          case 'f': putChar(js, '\f'); break;
+                          case 'u': js->uniCode   = 0;
+                                    js->uniDigits = 0;
+                                    js->state     = JS_UNICODE;
+                                    break;
+                          default:  putChar(js, c);   // '"', '\\' and '/'
+                        }
+                        break;
+                        
+      case JS_UNICODE:  js->uniCode <<= 4;
+                        if      (c >= '0' && c <= '9') js->uniCode |= (c - '0');
+                        else if (c >= 'a' && c <= 'f') js->uniCode |= (c - 'a' + 10);
+                        else if (c >= 'A' && c <= 'F') js->uniCode |= (c - 'A' + 10);
+                        if (++js->uniDigits == 4)
+                        {
+                          putCodePoint(js, js->uniCode);
+                          js->state = JS_STRING;
+                        }
+                        break;
+                        
+      case JS_SCALAR:   if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') 
+                                                   || c == '.' || c == '-' || c == '+' || c == 'E')
+                        {
+                          putChar(js, c);
+                        }
+                        else
+                        {
+                          js->state = JS_IDLE;
+                          endValue(js, false);
+                          if (!js->stopped) scanIdle(js, c);
+                        }
+                        break;
+    } // switch(state)
+  }
+  
+  return !js->stopped;
+  
+} // jsonScanFeed()
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* 
+****************************************************************************
+*/
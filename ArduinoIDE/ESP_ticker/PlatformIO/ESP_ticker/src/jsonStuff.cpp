@@ -10,18 +10,194 @@
 ***************************************************************************      
 */
 
-static char objSprtr[10] = "";
+//-- the whole response is collected in one packet sized buffer that is
+//-- only handed to the httpServer when it is full (or at the end)
+static char     jsonOut[NET_CHUNK_SIZE];
+static uint16_t jsonOutLen  = 0;
+static bool     jsonFirst   = true;
+static jsonSink jsonTo      = NULL;   // NULL: the httpServer response
 
 //=======================================================================
-void sendStartJsonObj(const char *objName)
+static void jsonFlush()
 {
-  char sBuff[50] = "";
-  objSprtr[0]    = '\0';
+  if (jsonOutLen == 0) return;
+  if (jsonTo != NULL) jsonTo(jsonOut, jsonOutLen);
+  else                httpServer.sendContent(jsonOut, jsonOutLen);
+  jsonOutLen = 0;
+  
+} // jsonFlush()
+
+
+//=======================================================================
+static void jsonPut(char c)
+{
+  if (jsonOutLen >= sizeof(jsonOut)) jsonFlush();
+  jsonOut[jsonOutLen++] = c;
+  
+} // jsonPut()
+
+
+//=======================================================================
+static void jsonPutRaw(const char *s)
+{
+  while (*s) jsonPut(*s++);
+  
+} // jsonPutRaw()
+
+
+//=======================================================================
+//-- one character, '"', '\' and control characters escaped
+static void jsonPutEscaped(uint8_t c)
+{
+  static const char hexChar[] = "0123456789abcdef";
+  
+  if (c == '"' || c == '\\')  { jsonPut('\\'); jsonPut(c); }
+  else if (c == '\n')         { jsonPut('\\'); jsonPut('n'); }
+  else if (c == '\r')         { jsonPut('\\'); jsonPut('r'); }
+  else if (c == '\t')         { jsonPut('\\'); jsonPut('t'); }
+  else if (c < 0x20)
+  {
+    jsonPutRaw("\\u00");
+    jsonPut(hexChar[c >> 4]);
+    jsonPut(hexChar[c & 0x0F]);
+  }
+  else jsonPut(c);
+  
+} // jsonPutEscaped()
+
+
+//=======================================================================
+//-- a quoted JSON string
+static void jsonPutString(const char *s)
+{
+  jsonPut('"');
+  for (; *s; s++) jsonPutEscaped((uint8_t)*s);
+  jsonPut('"');
+  
+} // jsonPutString()
+
+
+//=======================================================================
+//-- as jsonPutString() but for (display) Windows-1252 text, sent as UTF-8
+static void jsonPutLatin1String(const char *s)
+{
+  uint16_t  cp;
+  
+  jsonPut('"');
+  for (; *s; s++)
+  {
+    cp = latin1ToUnicode((uint8_t)*s);
+    if (cp == 0)          continue;   // not used in Windows-1252
+    if (cp < 0x80)        jsonPutEscaped(cp);
+    else if (cp < 0x800)
+    {
+      jsonPut(0xC0 | (cp >> 6));
+      jsonPut(0x80 | (cp & 0x3F));
+    }
+    else
+    {
+      jsonPut(0xE0 | (cp >> 12));
+      jsonPut(0x80 | ((cp >> 6) & 0x3F));
+      jsonPut(0x80 | (cp & 0x3F));
+    }
+  }
+  jsonPut('"');
+  
+} // jsonPutLatin1String()
+
+
+//=======================================================================
+static void jsonPutUint(uint32_t v)
+{
+  char  digits[11];
+  int   d = 0;
+  
+  do {
+    digits[d++] = '0' + (v % 10);
+    v /= 10;
+  } while (v > 0);
+  while (d > 0) jsonPut(digits[--d]);
+  
+} // jsonPutUint()
+
+
+//=======================================================================
+static void jsonPutInt(int32_t v)
+{
+  if (v < 0)
+  {
+    jsonPut('-');
+    jsonPutUint((uint32_t)0 - (uint32_t)v);
+  }
+  else jsonPutUint((uint32_t)v);
+  
+} // jsonPutInt()
+
+
+//=======================================================================
+static void jsonPutFloat(float v, int decPlaces)
+{
+  char  fBuff[20];
+  
+  if (isnan(v) || isinf(v))
+  {
+    jsonPutRaw("null");   // not valid in JSON
+    return;
+  }
+  if (decPlaces < 0 || decPlaces > 6) decPlaces = 6;
+  snprintf(fBuff, sizeof(fBuff), "%.*f", decPlaces, v);
+  jsonPutRaw(fBuff);
+  
+} // jsonPutFloat()
+
+
+//=======================================================================
+//-- '{"name": "<cName>", "value": ' with the separator if needed
+static void jsonStartField(const char *cName)
+{
+  if (!jsonFirst) jsonPutRaw(",\r\n");
+  jsonFirst = false;
+  jsonPutRaw("{\"name\": ");
+  jsonPutString(cName);
+  jsonPutRaw(", \"value\": ");
+  
+} // jsonStartField()
+
+
+//=======================================================================
+static void jsonTypeField(const char *cType)
+{
+  jsonPutRaw(", \"type\": ");
+  jsonPutString(cType);
+  
+} // jsonTypeField()
+
+
+//=======================================================================
+static void jsonMinMaxFields(int minValue, int maxValue)
+{
+  jsonPutRaw(", \"min\": ");
+  jsonPutInt(minValue);
+  jsonPutRaw(", \"max\": ");
+  jsonPutInt(maxValue);
+  jsonPut('}');
+  
+} // jsonMinMaxFields()
+
+
+//=======================================================================
+void sendStartJsonObj(const char *objName, int httpCode)
+{
+  jsonOutLen = 0;
+  jsonFirst  = true;
 
-  snprintf(sBuff, sizeof(sBuff), "{\"%s\":[\r\n", objName);
   httpServer.sendHeader("Access-Control-Allow-Origin", "*");
   httpServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
-  httpServer.send(200, "application/json", sBuff);
+  httpServer.send(httpCode, "application/json", "");
+
+  jsonPut('{');
+  jsonPutString(objName);
+  jsonPutRaw(":[\r\n");
   
 } // sendStartJsonObj()
 
@@ -29,7 +205,8 @@ void sendStartJsonObj(const char *objName)
 //=======================================================================
 void sendEndJsonObj()
 {
-  httpServer.sendContent("\r\n]}\r\n");
+  jsonPutRaw("\r\n]}\r\n");
+  jsonFlush();
 
   //httpServer.sendHeader( "Content-Length", "0");
   //httpServer.send ( 200, "application/json", "");
@@ -38,34 +215,75 @@ void sendEndJsonObj()
 
 
 //=======================================================================
-void sendNestedJsonObj(const char *cName, const char *cValue)
+//-- a bare array of objects: [{"key": "value", ..}, ..]
+void sendStartJsonList()
 {
-  char jsonBuff[JSON_BUFF_MAX] = "";
+  jsonOutLen = 0;
+  jsonFirst  = true;
+
+  httpServer.sendHeader("Access-Control-Allow-Origin", "*");
+  httpServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  httpServer.send(200, "application/json", "");
+
+  jsonPut('[');
   
-  snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": \"%s\"}"
-                                      , objSprtr, cName, cValue);
+} // sendStartJsonList()
 
-  httpServer.sendContent(jsonBuff);
-  sprintf(objSprtr, ",\r\n");
 
-} // sendNestedJsonObj(*char, *char)
+//=======================================================================
+void sendJsonListObjStart()
+{
+  if (!jsonFirst) jsonPutRaw(",\r\n");
+  jsonFirst = true;
+  jsonPut('{');
+  
+} // sendJsonListObjStart()
 
 
 //=======================================================================
-void sendNestedJsonObj(const char *cName, String sValue)
+void sendJsonListField(const char *cKey, const char *cValue)
 {
-  char jsonBuff[JSON_BUFF_MAX] = "";
+  if (!jsonFirst) jsonPutRaw(", ");
+  jsonFirst = false;
+  jsonPutString(cKey);
+  jsonPutRaw(": ");
+  jsonPutString(cValue);
   
-  if (sValue.length() > (JSON_BUFF_MAX - 65) )
-  {
-    DebugTf("[2] sValue.length() [%d]\r\n", sValue.length());
-  }
+} // sendJsonListField()
+
+
+//=======================================================================
+void sendJsonListObjEnd()
+{
+  jsonPut('}');
+  jsonFirst = false;
+  
+} // sendJsonListObjEnd()
+
+
+//=======================================================================
+void sendEndJsonList()
+{
+  jsonPutRaw("]\r\n");
+  jsonFlush();
   
-    snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": \"%s\"}"
-                                     , objSprtr, cName, sValue.c_str());
+} // sendEndJsonList()
+
+
+//=======================================================================
+void sendNestedJsonObj(const char *cName, const char *cValue)
+{
+  jsonStartField(cName);
+  jsonPutString(cValue);
+  jsonPut('}');
+
+} // sendNestedJsonObj(*char, *char)
 
-  httpServer.sendContent(jsonBuff);
-  sprintf(objSprtr, ",\r\n");
+
+//=======================================================================
+void sendNestedJsonObj(const char *cName, const String &sValue)
+{
+  sendNestedJsonObj(cName, sValue.c_str());
 
 } // sendNestedJsonObj(*char, String)
 
@@ -73,26 +291,18 @@ void sendNestedJsonObj(const char *cName, String sValue)
 //=======================================================================
 void sendNestedJsonObj(const char *cName, int32_t iValue)
 {
-  char jsonBuff[200] = "";
-  
-  snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": %d}"
-                                      , objSprtr, cName, iValue);
-
-  httpServer.sendContent(jsonBuff);
-  sprintf(objSprtr, ",\r\n");
+  jsonStartField(cName);
+  jsonPutInt(iValue);
+  jsonPut('}');
 
 } // sendNestedJsonObj(*char, int)
 
 //=======================================================================
 void sendNestedJsonObj(const char *cName, uint32_t uValue)
 {
-  char jsonBuff[200] = "";
-  
-  snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": %u }"
-                                      , objSprtr, cName, uValue);
-
-  httpServer.sendContent(jsonBuff);
-  sprintf(objSprtr, ",\r\n");
+  jsonStartField(cName);
+  jsonPutUint(uValue);
+  jsonPut('}');
 
 } // sendNestedJsonObj(*char, uint)
 
@@ -100,29 +310,35 @@ void sendNestedJsonObj(const char *cName, uint32_t uValue)
 //=======================================================================
 void sendNestedJsonObj(const char *cName, float fValue)
 {
-  char jsonBuff[200] = "";
-  
-  snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": %.3f }"
-                                      , objSprtr, cName, fValue);
-
-  httpServer.sendContent(jsonBuff);
-  sprintf(objSprtr, ",\r\n");
+  jsonStartField(cName);
+  jsonPutFloat(fValue, 3);
+  jsonPut('}');
 
 } // sendNestedJsonObj(*char, float)
 
 
+//=======================================================================
+//-- {"name": "<cName>", "value": [v0, v1, ..]}
+void sendNestedJsonArray(const char *cName, const uint32_t *values, uint8_t count)
+{
+  jsonStartField(cName);
+  jsonPut('[');
+  for (uint8_t i=0; i<count; i++)
+  {
+    if (i > 0) jsonPutRaw(", ");
+    jsonPutUint(values[i]);
+  }
+  jsonPutRaw("]}");
+
+} // sendNestedJsonArray()
+
+
 //=======================================================================
 // ************ function to build Json Settings string ******************
 //=======================================================================
 void sendJsonSettingObj(const char *cName, float fValue, const char *fType, int minValue, int maxValue)
 {
-  char jsonBuff[200] = "";
-
-  snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": %.3f, \"type\": \"%s\", \"min\": %d, \"max\": %d}"
-                                      , objSprtr, cName, fValue, fType, minValue, maxValue);
-
-  httpServer.sendContent(jsonBuff);
-  sprintf(objSprtr, ",\r\n");
+  sendJsonSettingObj(cName, fValue, fType, minValue, maxValue, 3);
 
 } // sendJsonSettingObj(*char, float, *char, int, int)
 
@@ -130,29 +346,10 @@ void sendJsonSettingObj(const char *cName, float fValue, const char *fType, int
 //=======================================================================
 void sendJsonSettingObj(const char *cName, float fValue, const char *fType, int minValue, int maxValue, int decPlaces)
 {
-  char jsonBuff[200] = "";
-
-  switch(decPlaces) {
-    case 0:
-      snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": %.0f, \"type\": \"%s\", \"min\": %d, \"max\": %d}"
-                                      , objSprtr, cName, fValue, fType, minValue, maxValue);
-      break;
-    case 2:
-      snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": %.2f, \"type\": \"%s\", \"min\": %d, \"max\": %d}"
-                                      , objSprtr, cName, fValue, fType, minValue, maxValue);
-      break;
-    case 5:
-      snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": %.5f, \"type\": \"%s\", \"min\": %d, \"max\": %d}"
-                                      , objSprtr, cName, fValue, fType, minValue, maxValue);
-      break;
-    default:
-      snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": %f, \"type\": \"%s\", \"min\": %d, \"max\": %d}"
-                                      , objSprtr, cName, fValue, fType, minValue, maxValue);
-
-  }
-
-  httpServer.sendContent(jsonBuff);
-  sprintf(objSprtr, ",\r\n");
+  jsonStartField(cName);
+  jsonPutFloat(fValue, decPlaces);
+  jsonTypeField(fType);
+  jsonMinMaxFields(minValue, maxValue);
 
 } // sendJsonSettingObj(*char, float, *char, int, int, int)
 
@@ -160,13 +357,10 @@ void sendJsonSettingObj(const char *cName, float fValue, const char *fType, int
 //=======================================================================
 void sendJsonSettingObj(const char *cName, int iValue, const char *iType, int minValue, int maxValue)
 {
-  char jsonBuff[200] = "";
-
-  snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\": %d, \"type\": \"%s\", \"min\": %d, \"max\": %d}"
-                                      , objSprtr, cName, iValue, iType, minValue, maxValue);
-
-  httpServer.sendContent(jsonBuff);
-  sprintf(objSprtr, ",\r\n");
+  jsonStartField(cName);
+  jsonPutInt(iValue);
+  jsonTypeField(iType);
+  jsonMinMaxFields(minValue, maxValue);
 
 } // sendJsonSettingObj(*char, int, *char, int, int)
 
@@ -174,15 +368,50 @@ void sendJsonSettingObj(const char *cName, int iValue, const char *iType, int mi
 //=======================================================================
 void sendJsonSettingObj(const char *cName, const char *cValue, const char *sType, int maxLen)
 {
-  char jsonBuff[200] = "";
+  jsonStartField(cName);
+  jsonPutString(cValue);
+  jsonTypeField(sType);
+  jsonPutRaw(", \"maxlen\": ");
+  jsonPutInt(maxLen);
+  jsonPut('}');
 
-  snprintf(jsonBuff, sizeof(jsonBuff), "%s{\"name\": \"%s\", \"value\":\"%s\", \"type\": \"%s\", \"maxlen\": %d}"
-                                      , objSprtr, cName, cValue, sType, maxLen);
+} // sendJsonSettingObj(*char, *char, *char, int, int)
 
-  httpServer.sendContent(jsonBuff);
-  sprintf(objSprtr, ",\r\n");
 
-} // sendJsonSettingObj(*char, *char, *char, int, int)
+//=======================================================================
+//-- a stored message, the same as a "s" setting
+void sendJsonMessageObj(const char *cName, const char *cValue, int maxLen)
+{
+  jsonStartField(cName);
+  jsonPutLatin1String(cValue);
+  jsonTypeField("s");
+  jsonPutRaw(", \"maxlen\": ");
+  jsonPutInt(maxLen);
+  jsonPut('}');
+
+} // sendJsonMessageObj()
+
+
+//=======================================================================
+//-- one Server-Sent Event with a {"name": .., "value": ..} as data, it
+//-- goes to sink (not to the httpServer), never during a response
+void sendJsonEvent(jsonSink sink, const char *type, const char *cName, const char *cValue, bool isLatin1)
+{
+  jsonTo     = sink;
+  jsonOutLen = 0;
+  jsonFirst  = true;
+  
+  jsonPutRaw("event: ");
+  jsonPutRaw(type);
+  jsonPutRaw("\ndata: ");
+  jsonStartField(cName);
+  if (isLatin1) jsonPutLatin1String(cValue);
+  else          jsonPutString(cValue);
+  jsonPutRaw("}\n\n");
+  jsonFlush();
+  jsonTo     = NULL;
+
+} // sendJsonEvent()
 
 
 
@@ -1,4 +1,5 @@
 #include "littlefsStuff.h"
+#include "helperStuff.h"
 
 /* 
 ***************************************************************************  
@@ -43,7 +44,7 @@ void writeLastStatus()
 {
   if (ESP.getFreeHeap() < 8500) // to prevent firmware from crashing!
   {
-    DebugTf("Bailout due to low heap (%d bytes)\r\n", ESP.getFreeHeap());
+    ErrorTf("Bailout due to low heap (%d bytes)\r\n", ESP.getFreeHeap());
     return;
   }
   char buffer[50] = "";
@@ -54,65 +55,528 @@ void writeLastStatus()
                                           , "meta data");
   DebugTf("writeLastStatus() => %s\r\n", buffer);
 
+  uint32_t start = micros();
   File _file = LittleFS.open("/sysStatus.csv", "w");
   if (!_file)
   {
     DebugTln("write(): No /sysStatus.csv found ..");
   }
   _file.print(buffer);
-  _file.flush();
   _file.close();
+  metricsFsOp(true, start);
   
 } // writeLastStatus()
 
 
+//====================================================================
+//-- the last weather message, shown at boot until the first fetch is done
+static uint32_t lastWeatherCrc = 0;   // of what WEATHER_FILE holds, 0 = not known
+
+void readLastWeather(char *dest, int maxLen)
+{
+  File _file = LittleFS.open(WEATHER_FILE, "r");
+  if (!_file)
+  {
+    DebugTln("read(): No " WEATHER_FILE " found ..");
+    return;
+  }
+  int l = _file.readBytes(dest, maxLen-1);
+  dest[l] = '\0';
+  _file.close();
+  lastWeatherCrc = calcCRC32(dest, l);
+  DebugTf("lastWeather[%s]\r\n", dest);
+  
+} // readLastWeather()
+
+
+//====================================================================
+//-- only when it changed, weerlive often sends the same for hours
+void writeLastWeather(const char *weather)
+{
+  uint32_t crc = calcCRC32(weather, strlen(weather));
+  if (crc == lastWeatherCrc) return;
+
+  uint32_t start = micros();
+  File _file = LittleFS.open(WEATHER_FILE, "w");
+  if (!_file)
+  {
+    ErrorTf("write(): could not open %s\r\n", WEATHER_FILE);
+    return;
+  }
+  _file.print(weather);
+  _file.close();
+  metricsFsOp(true, start);
+  lastWeatherCrc = crc;
+  
+} // writeLastWeather()
+
+
 //------------------------------------------------------------------------
-bool readFileById(const char* fType, uint8_t mId)
+//-- All LCL and NWS messages live in one preallocated file with a fixed
+//-- size record per slot (LCL-000..LCL-020 followed by NWS-000..NWS-020).
+//-- Updating a message is a write in place, not a new file, and between
+//-- beginMessageBatch() and commitMessageBatch() all changed slots are
+//-- written with a single open/close.
+#define MSG_STORE_FILE  "/newsFiles/messages.dat"
+#define MSG_TEXT_SIZE   (LOCAL_SIZE -1)
+#define MSG_RECORDS     (2 * MAX_MSG_SLOTS)
+
+typedef struct _msgRecordHeader {
+  uint32_t  generation;   // store commit that wrote this record
+  uint32_t  crc;          // CRC32 of the text
+  uint16_t  len;          // 0 = empty slot
+  uint16_t  flags;
+  uint32_t  expires;      // now() after which a LCL message is removed, 0 = never
+} msgRecordHeader;
+
+#define MSG_REC_LATIN1  0x0001  // text is already converted for the display
+#define MSG_REC_URGENT  0x0002  // LCL message that goes before the playlist
+
+#define MSG_RECORD_SIZE (sizeof(msgRecordHeader) + MSG_TEXT_SIZE)
+
+static uint32_t msgGeneration = 0;
+static uint8_t  msgBatchDepth = 0;
+static uint8_t  msgDirty[(MSG_RECORDS +7) / 8];
+//-- CRC32 of the text of every slot (0 = empty), a write of the same text
+//-- is skipped, so refreshing unchanged messages costs no flash writes
+static uint32_t msgCrc[MSG_RECORDS];
+#define MSG_CRC_BAD     0xFFFFFFFF
+
+//-- which slots hold a message (bit n is slot n, MAX_MSG_SLOTS <= 32) so
+//-- the playlist finds the next one without looking at empty slots, and
+//-- the urgent flag and expiry of the LCL messages
+static uint32_t msgSlotBits[2];     // [0] LCL, [1] NWS
+static uint32_t msgUrgentBits = 0;
+static uint32_t msgExpires[MAX_MSG_SLOTS];
+static uint32_t msgNextExpiry = 0;  // the first msgExpires[] that is due, 0 = none
+static uint32_t msgPushBits   = 0;  // LCL slots changed since the last push
+
+//------------------------------------------------------------------------
+//-- RAM copy of all LCL and NWS messages (already decoded). It is filled
+//-- once at boot by loadMessageCache() and kept up-to-date by
+//-- writeFileById() so the display and REST paths never read LittleFS.
+//-- All messages share one arena; a slot that does not fit in the arena
+//-- falls back to reading its record.
+#define MSG_NOT_CACHED  0xFFFF
+
+typedef struct _msgSlot {
+  uint16_t  offset;
+  uint8_t   len;
+} msgSlot;
+
+static char     msgArena[MSG_CACHE_SIZE];
+static uint16_t msgArenaUsed = 0;
+static msgSlot  lclSlots[MAX_MSG_SLOTS];
+static msgSlot  nwsSlots[MAX_MSG_SLOTS];
+
+//------------------------------------------------------------------------
+static msgSlot *cacheSlot(const char* fType, uint8_t mId)
+{
+  if (mId >= MAX_MSG_SLOTS) return NULL;
+  if (fType[0] == 'L')      return &lclSlots[mId];
+  return &nwsSlots[mId];
+  
+} // cacheSlot()
+
+//------------------------------------------------------------------------
+//-- remove the text of a slot from the arena and close the gap
+static void cacheRelease(msgSlot *slot)
 {
-  String percChar   = "%%";
-  String backSlash  = "\\";
-  String rTmp;
-  char fName[50] = "";
+  if (slot->offset != MSG_NOT_CACHED && slot->len > 0)
+  {
+    uint16_t gapStart = slot->offset;
+    uint16_t gapLen   = slot->len;
+    memmove(&msgArena[gapStart], &msgArena[gapStart + gapLen], msgArenaUsed - (gapStart + gapLen));
+    msgArenaUsed -= gapLen;
+    for (int i=0; i<MAX_MSG_SLOTS; i++)
+    {
+      if (lclSlots[i].offset != MSG_NOT_CACHED && lclSlots[i].offset > gapStart) lclSlots[i].offset -= gapLen;
+      if (nwsSlots[i].offset != MSG_NOT_CACHED && nwsSlots[i].offset > gapStart) nwsSlots[i].offset -= gapLen;
+    }
+  }
+  slot->offset = 0;
+  slot->len    = 0;
   
-  sprintf(fName, "/newsFiles/%s-%03d", fType, mId);
+} // cacheRelease()
 
-  DebugTf("read [%s] ", fName);
+//------------------------------------------------------------------------
+//-- false if the message did not fit in the arena
+static bool cacheStore(const char* fType, uint8_t mId, const char *msg)
+{
+  msgSlot *slot = cacheSlot(fType, mId);
+  if (slot == NULL) return false;
+
+  cacheRelease(slot);
+  
+  uint32_t *bits = &msgSlotBits[(fType[0] == 'L') ? 0 : 1];
+  int       len  = strlen(msg);
+  *bits &= ~(1UL << mId);
+  if (len == 0) return true;
+  *bits |= (1UL << mId);
   
-  if (!LittleFS.exists(fName)) 
+  if (len > MSG_TEXT_SIZE) len = MSG_TEXT_SIZE;
+  if ((msgArenaUsed + len) > MSG_CACHE_SIZE)
   {
-    Debugln("Does not exist!");
+    ErrorTf("no room in cache for [%s-%03d] (%d bytes)!\r\n", fType, mId, len);
+    slot->offset = MSG_NOT_CACHED;
     return false;
   }
+  memcpy(&msgArena[msgArenaUsed], msg, len);
+  slot->offset  = msgArenaUsed;
+  slot->len     = len;
+  msgArenaUsed += len;
+  return true;
+  
+} // cacheStore()
 
-  File f = LittleFS.open(fName, "r");
+//------------------------------------------------------------------------
+//-- decode the '@n@' escapes the web-page puts in a message in one pass:
+//--    @1@ ':'   @2@ '{'   @3@ '}'   @4@ ','   @5@ '\'   @6@ '%'
+//-- The result is never longer than src, so dest may be src (in place)
+static void decodeMessage(const char *src, char *dest, int maxLen)
+{
+  static const char escChar[] = ":{},\\%";
+  int               d = 0;
+  
+  while (*src && d < (maxLen -1))
+  {
+    if (src[0] == '@' && src[1] >= '1' && src[1] <= '6' && src[2] == '@')
+    {
+      dest[d++] = escChar[src[1] - '1'];
+      src += 3;
+      continue;
+    }
+    dest[d++] = *src++;
+  }
+  dest[d] = '\0';
+  
+} // decodeMessage()
+
+//------------------------------------------------------------------------
+static int msgRecordNr(const char* fType, uint8_t mId)
+{
+  if (mId >= MAX_MSG_SLOTS) return -1;
+  return ((fType[0] == 'L') ? 0 : MAX_MSG_SLOTS) + mId;
+  
+} // msgRecordNr()
+
+//------------------------------------------------------------------------
+static bool writeRecord(File &f, int rec, const char *text)
+{
+  msgRecordHeader hdr;
+  uint32_t        start = micros();
+  bool            ok;
+  
+  hdr.len        = strlen(text);
+  if (hdr.len > MSG_TEXT_SIZE) hdr.len = MSG_TEXT_SIZE;
+  hdr.generation = msgGeneration;
+  hdr.crc        = calcCRC32(text, hdr.len);
+  hdr.flags      = MSG_REC_LATIN1;
+  hdr.expires    = 0;
+  if (rec < MAX_MSG_SLOTS)
+  {
+    if (msgUrgentBits & (1UL << rec)) hdr.flags |= MSG_REC_URGENT;
+    hdr.expires = msgExpires[rec];
+  }
+  
+  ok = (f.seek(rec * MSG_RECORD_SIZE, SeekSet)
+        && f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr)
+        && f.write((const uint8_t*)text, hdr.len) == hdr.len);
+  metricsFsOp(true, start);
+  msgCrc[rec] = ok ? hdr.crc : MSG_CRC_BAD;
+  return ok;
+  
+} // writeRecord()
+
+//------------------------------------------------------------------------
+//-- dest must hold LOCAL_SIZE chars, false for an empty or corrupt record
+static bool readRecord(File &f, int rec, char *dest)
+{
+  msgRecordHeader hdr;
+  uint32_t        start = micros();
+  bool            ok;
+
+  dest[0] = '\0';
+  ok = (f.seek(rec * MSG_RECORD_SIZE, SeekSet)
+        && f.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr));
+  if (ok && hdr.len > 0 && hdr.len <= MSG_TEXT_SIZE)
+  {
+    ok = (f.read((uint8_t*)dest, hdr.len) == hdr.len);
+  }
+  metricsFsOp(false, start);
+  
+  msgCrc[rec] = MSG_CRC_BAD;
+  if (!ok)                                      return false;
+  if (hdr.generation > msgGeneration) msgGeneration = hdr.generation;
+  if (hdr.len == 0)                             msgCrc[rec] = 0;
+  if (hdr.len == 0 || hdr.len > MSG_TEXT_SIZE)  return false;
+  dest[hdr.len] = '\0';
+  if (calcCRC32(dest, hdr.len) != hdr.crc)
+  {
+    ErrorTf("record [%d] has a bad CRC, skipped!\r\n", rec);
+    dest[0] = '\0';
+    return false;
+  }
+  msgCrc[rec] = hdr.crc;
+  if (!(hdr.flags & MSG_REC_LATIN1)) utf8ToLatin1(dest);
+  if (rec < MAX_MSG_SLOTS)
+  {
+    if (hdr.flags & MSG_REC_URGENT) msgUrgentBits |=  (1UL << rec);
+    else                            msgUrgentBits &= ~(1UL << rec);
+    msgExpires[rec] = hdr.expires;
+  }
+  return true;
+  
+} // readRecord()
+
+//------------------------------------------------------------------------
+//-- only the flags and expiry in the header of a record change
+static bool writeRecordOptions(File &f, int rec)
+{
+  msgRecordHeader hdr;
+  uint32_t        start = micros();
+  bool            ok;
+  
+  ok = (f.seek(rec * MSG_RECORD_SIZE, SeekSet)
+        && f.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr)
+        && hdr.len > 0);
+  if (ok)
+  {
+    hdr.flags  &= ~MSG_REC_URGENT;
+    if (msgUrgentBits & (1UL << rec)) hdr.flags |= MSG_REC_URGENT;
+    hdr.expires = msgExpires[rec];
+    ok = (f.seek(rec * MSG_RECORD_SIZE, SeekSet)
+          && f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr));
+  }
+  metricsFsOp(true, start);
+  return ok;
+  
+} // writeRecordOptions()
 
+//------------------------------------------------------------------------
+static void updateNextExpiry()
+{
+  msgNextExpiry = 0;
+  for (int i=0; i<MAX_MSG_SLOTS; i++)
+  {
+    if (msgExpires[i] != 0 && (msgNextExpiry == 0 || msgExpires[i] < msgNextExpiry)) msgNextExpiry = msgExpires[i];
+  }
+  
+} // updateNextExpiry()
+
+//------------------------------------------------------------------------
+//-- read an old style '/newsFiles/XXX-nnn' file into fileMessage
+static bool readMessageFile(const char *fName)
+{
+  int len;
+
+  fileMessage[0] = '\0';
+  if (!LittleFS.exists(fName)) return false;
+
+  File f = LittleFS.open(fName, "r");
   while(f.available()) 
   {
-    rTmp = f.readStringUntil('\n');
-    //Debugf("rTmp(in)  [%s]\r\n", rTmp.c_str());
-    rTmp.replace("\r", "");
+    //-- the last line counts
+    len = f.readBytesUntil('\n', fileMessage, MSG_TEXT_SIZE);
+    if (len > 0 && fileMessage[len -1] == '\r') len--;
+    fileMessage[len] = '\0';
+  }
+  f.close();
+
+  decodeMessage(fileMessage, fileMessage, LOCAL_SIZE);
+  return (strlen(fileMessage) > 0);
+  
+} // readMessageFile()
+
+//------------------------------------------------------------------------
+//-- create the (empty) message store and move old message files into it
+static bool createMessageStore()
+{
+  char            fName[50] = "";
+  msgRecordHeader hdr;
+  
+  DebugTf("create [%s] with [%d] records\r\n", MSG_STORE_FILE, MSG_RECORDS);
+  File f = LittleFS.open(MSG_STORE_FILE, "w");
+  if (!f)
+  {
+    ErrorTf("open(%s, 'w') FAILED!!! --> Bailout\r\n", MSG_STORE_FILE);
+    return false;
+  }
+  memset(&hdr, 0, sizeof(hdr));
+  memset(fileMessage, 0, MSG_TEXT_SIZE);
+  for (int rec=0; rec<MSG_RECORDS; rec++)
+  {
+    f.write((const uint8_t*)&hdr, sizeof(hdr));
+    f.write((const uint8_t*)fileMessage, MSG_TEXT_SIZE);
+  }
+
+  for (int i=0; i<MAX_MSG_SLOTS; i++)
+  {
+    sprintf(fName, "/newsFiles/LCL-%03d", i);
+    if (readMessageFile(fName) && utf8ToLatin1(fileMessage) > 0) writeRecord(f, msgRecordNr("LCL", i), fileMessage);
+    LittleFS.remove(fName);
+    sprintf(fName, "/newsFiles/NWS-%03d", i);
+    if (readMessageFile(fName) && utf8ToLatin1(fileMessage) > 0) writeRecord(f, msgRecordNr("NWS", i), fileMessage);
+    LittleFS.remove(fName);
+    yield();
+  }
+  f.close();
+  fileMessage[0] = '\0';
+  return true;
+  
+} // createMessageStore()
+
+//------------------------------------------------------------------------
+static File openMessageStore()
+{
+  if (!LittleFS.exists(MSG_STORE_FILE)) createMessageStore();
+  return LittleFS.open(MSG_STORE_FILE, "r+");
+  
+} // openMessageStore()
+
+//------------------------------------------------------------------------
+void loadMessageCache()
+{
+  msgArenaUsed   = 0;
+  msgSlotBits[0] = 0;
+  msgSlotBits[1] = 0;
+  msgUrgentBits  = 0;
+  for (int i=0; i<MAX_MSG_SLOTS; i++)
+  {
+    lclSlots[i].offset = 0;  lclSlots[i].len = 0;
+    nwsSlots[i].offset = 0;  nwsSlots[i].len = 0;
+    msgExpires[i]      = 0;
+  }
+  
+  File f = openMessageStore();
+  if (f && f.size() != (MSG_RECORDS * MSG_RECORD_SIZE))
+  {
+    //-- cut short (power lost while it was created): start again empty
+    ErrorTf("[%s] has [%u] bytes, created again\r\n", MSG_STORE_FILE, (uint32_t)f.size());
+    f.close();
+    LittleFS.remove(MSG_STORE_FILE);
+    f = openMessageStore();
+  }
+  if (!f)
+  {
+    ErrorTf("open(%s) FAILED!!!\r\n", MSG_STORE_FILE);
+    return;
+  }
+  for (int i=0; i<MAX_MSG_SLOTS; i++)
+  {
+    if (readRecord(f, msgRecordNr("LCL", i), fileMessage)) cacheStore("LCL", i, fileMessage);
+    if (readRecord(f, msgRecordNr("NWS", i), fileMessage)) cacheStore("NWS", i, fileMessage);
+  }
+  f.close();
+  fileMessage[0] = '\0';
+  updateNextExpiry();
+  
+  DebugTf("message cache uses [%d] of [%d] bytes, generation [%u]\r\n"
+                                      , msgArenaUsed, MSG_CACHE_SIZE, msgGeneration);
+  
+} // loadMessageCache()
+
+//------------------------------------------------------------------------
+//-- slots written until commitMessageBatch() only go to the cache
+void beginMessageBatch()
+{
+  msgBatchDepth++;
+  
+} // beginMessageBatch()
+
+//------------------------------------------------------------------------
+void commitMessageBatch()
+{
+  int written = 0;
+  
+  if (msgBatchDepth == 0 || --msgBatchDepth > 0) return;
+
+  bool dirty = false;
+  for (unsigned b=0; b<sizeof(msgDirty); b++) dirty |= (msgDirty[b] != 0);
+  if (!dirty) return;
+  
+  File f = openMessageStore();
+  if (!f)
+  {
+    ErrorTf("open(%s) FAILED!!! --> Bailout\r\n", MSG_STORE_FILE);
+    return;
+  }
+  msgGeneration++;
+  for (int rec=0; rec<MSG_RECORDS; rec++)
+  {
+    if (!(msgDirty[rec >> 3] & (1 << (rec & 7)))) continue;
+    uint8_t  mId  = rec % MAX_MSG_SLOTS;
+    msgSlot *slot = cacheSlot((rec < MAX_MSG_SLOTS) ? "LCL" : "NWS", mId);
+    msgDirty[rec >> 3] &= ~(1 << (rec & 7));
+    if (slot->offset == MSG_NOT_CACHED) continue;
+    memcpy(fileMessage, &msgArena[slot->offset], slot->len);
+    fileMessage[slot->len] = '\0';
+    if (!writeRecord(f, rec, fileMessage))
+    {
+      msgDirty[rec >> 3] |= (1 << (rec & 7));   //-- the next commit tries again
+      continue;
+    }
+    written++;
   }
   f.close();
+  DebugTf("committed [%d] messages in generation [%u]\r\n", written, msgGeneration);
+  
+} // commitMessageBatch()
 
-  rTmp.replace("@1@", ":");
-  rTmp.replace("@2@", "{");
-  rTmp.replace("@3@", "}");
-  rTmp.replace("@4@", ",");
-  rTmp.replace("@5@", backSlash);
-  rTmp.replace("@6@", percChar);
-  //DebugTf("rTmp(out) [%s]\r\n", rTmp.c_str());
-    
-  snprintf(fileMessage, LOCAL_SIZE, rTmp.c_str());
+//------------------------------------------------------------------------
+bool hasMessage(const char* fType, uint8_t mId)
+{
+  msgSlot *slot = cacheSlot(fType, mId);
+  
+  if (slot == NULL) return false;
+  if (slot->offset != MSG_NOT_CACHED) return (slot->len > 0);
+  
+  File f = openMessageStore();
+  bool found = readRecord(f, msgRecordNr(fType, mId), fileMessage);
+  f.close();
+  return found;
+  
+} // hasMessage()
+
+//------------------------------------------------------------------------
+bool readFileById(const char* fType, uint8_t mId)
+{
+  msgSlot *slot = cacheSlot(fType, mId);
+  
+  DebugTf("read [%s-%03d] ", fType, mId);
+
+  fileMessage[0] = '\0';
+  if (slot == NULL)
+  {
+    Debugln("Does not exist!");
+    return false;
+  }
+  if (slot->offset != MSG_NOT_CACHED)
+  {
+    memcpy(fileMessage, &msgArena[slot->offset], slot->len);
+    fileMessage[slot->len] = '\0';
+  }
+  else
+  {
+    File f = openMessageStore();
+    readRecord(f, msgRecordNr(fType, mId), fileMessage);
+    f.close();
+  }
+  
   if (strlen(fileMessage) == 0)
   {
-    Debugln("file is zero bytes long");
+    Debugln("is empty");
     return false;
   }
   Debugf("OK! \r\n\t[%s]\r\n", fileMessage);
 
-  if (mId == 0)
+  //-- LCL-000 is only shown once
+  if (mId == 0 && fType[0] == 'L')
   {
-    LittleFS.remove("/newsFiles/LCL-000");
+    char shown[LOCAL_SIZE];
+    strCopy(shown, sizeof(shown), fileMessage);
+    writeFileById("LCL", 0, "");
+    strCopy(fileMessage, LOCAL_SIZE, shown);
     DebugTln("Remove LCL-000 ..");
   }
 
@@ -123,44 +587,168 @@ bool readFileById(const char* fType, uint8_t mId)
 //------------------------------------------------------------------------
 bool writeFileById(const char* fType, uint8_t mId, const char *msg)
 {
-  String rTmp;
-  char fName[50] = "";
-  sprintf(fName, "/newsFiles/%s-%03d", fType, mId);
+  char decoded[LOCAL_SIZE] = "";
+  int  rec = msgRecordNr(fType, mId);
 
-  DebugTf("write [%s]-> [%s]\r\n", fName, msg);
+  DebugTf("write [%s-%03d]-> [%s]\r\n", fType, mId, msg);
+  if (rec < 0)
+  {
+    DebugTf("msgId[%d] is out of scope! Bailing out!\r\n", mId);
+    return false;
+  }
 
-  if (strlen(msg) < 3)
+  //-- a message shorter than 3 chars empties the slot
+  if (strlen(msg) >= 3) decodeMessage(msg, decoded, sizeof(decoded));
+  //-- stored (and cached) the way it is displayed
+  utf8ToLatin1(decoded);
+  //-- an emptied LCL slot loses its urgent flag and expiry
+  if (decoded[0] == '\0' && rec < MAX_MSG_SLOTS && (msgExpires[rec] != 0 || (msgUrgentBits & (1UL << rec))))
   {
-    LittleFS.remove(fName);
-    Debugln("Empty message, file removed!");
+    msgUrgentBits  &= ~(1UL << rec);
+    msgExpires[rec] = 0;
+    updateNextExpiry();
+  }
+  uint32_t crc = calcCRC32(decoded, strlen(decoded));
+  if (crc == msgCrc[rec])
+  {
+    DebugTf("[%s-%03d] unchanged, not written\r\n", fType, mId);
     return true;
   }
+  if (rec < MAX_MSG_SLOTS) msgPushBits |= (1UL << rec);
+  bool cached = cacheStore(fType, mId, decoded);
 
-  DebugTln("LittleFS.open()...");
-  File file = LittleFS.open(fName, "w");
-  if (!file) 
+  if (msgBatchDepth > 0 && cached)
   {
-    Debugf("open(%s, 'w') FAILED!!! --> Bailout\r\n", fName);
+    //-- commitMessageBatch() writes it, a failed write resets the CRC
+    msgCrc[rec] = crc;
+    msgDirty[rec >> 3] |= (1 << (rec & 7));
+    return true;
+  }
+
+  File f = openMessageStore();
+  if (!f) 
+  {
+    ErrorTf("open(%s, 'r+') FAILED!!! --> Bailout\r\n", MSG_STORE_FILE);
+    //-- not on flash: the same text is written again, a commit takes it along
+    msgCrc[rec] = MSG_CRC_BAD;
+    if (cached) msgDirty[rec >> 3] |= (1 << (rec & 7));
     return false;
   }
   yield();
-
-  Debugln(F("Start writing data .. \r"));
-  DebugFlush();
-  Debugln(msg);
-  file.println(msg);
-  file.close();
+  msgGeneration++;
+  bool written = writeRecord(f, rec, decoded);   //-- sets msgCrc[rec]
+  f.close();
+  if (written) msgDirty[rec >> 3] &= ~(1 << (rec & 7));
 
   DebugTln("Exit writeFileById()!");
-  return true;
+  return written;
   
 } // writeFileById()
 
 
+//------------------------------------------------------------------------
+//-- bit n is set when slot n of fType holds a message
+uint32_t messageSlots(const char* fType)
+{
+  return msgSlotBits[(fType[0] == 'L') ? 0 : 1];
+  
+} // messageSlots()
+
+//------------------------------------------------------------------------
+//-- the next LCL slot whose text changed, for the push channel, -1 if none
+int8_t nextChangedMessage()
+{
+  if (msgPushBits == 0) return -1;
+  
+  uint8_t mId = __builtin_ctz(msgPushBits);
+  msgPushBits &= ~(1UL << mId);
+  return mId;
+  
+} // nextChangedMessage()
+
+//------------------------------------------------------------------------
+//-- the LCL slots that hold an urgent message
+uint32_t urgentMessages()
+{
+  return (msgUrgentBits & msgSlotBits[0]);
+  
+} // urgentMessages()
+
+//------------------------------------------------------------------------
+//-- expires is a now() value, 0 = never
+uint32_t messageExpires(uint8_t mId)
+{
+  return (mId < MAX_MSG_SLOTS) ? msgExpires[mId] : 0;
+  
+} // messageExpires()
+
+//------------------------------------------------------------------------
+//-- false if LCL-mId has no message
+bool setMessageOptions(uint8_t mId, bool urgent, uint32_t expires)
+{
+  if (mId >= MAX_MSG_SLOTS || !(msgSlotBits[0] & (1UL << mId))) return false;
+
+  bool wasUrgent = (msgUrgentBits & (1UL << mId));
+  if (wasUrgent == urgent && msgExpires[mId] == expires)       return true;
+  
+  DebugTf("[LCL-%03d] urgent[%d] expires[%u]\r\n", mId, urgent, expires);
+  if (urgent) msgUrgentBits |=  (1UL << mId);
+  else        msgUrgentBits &= ~(1UL << mId);
+  msgExpires[mId] = expires;
+  updateNextExpiry();
+  
+  if (msgBatchDepth > 0 && lclSlots[mId].offset != MSG_NOT_CACHED)
+  {
+    msgDirty[mId >> 3] |= (1 << (mId & 7));
+    return true;
+  }
+  File f = openMessageStore();
+  if (!f)
+  {
+    ErrorTf("open(%s, 'r+') FAILED!!! --> Bailout\r\n", MSG_STORE_FILE);
+    return false;
+  }
+  bool written = writeRecordOptions(f, msgRecordNr("LCL", mId));
+  f.close();
+  return written;
+  
+} // setMessageOptions()
+
+//------------------------------------------------------------------------
+//-- remove the LCL messages whose time (a now() value) is up
+void expireMessages(uint32_t nowSec)
+{
+  if (msgNextExpiry == 0 || nowSec < msgNextExpiry) return;
+  
+  for (int i=0; i<MAX_MSG_SLOTS; i++)
+  {
+    if (msgExpires[i] == 0 || nowSec < msgExpires[i]) continue;
+    InfoTf("[LCL-%03d] expired\r\n", i);
+    writeFileById("LCL", i, "");
+  }
+  
+} // expireMessages()
+
+
+//=======================================================================
+//-- NULL if newValue can be stored as local message field, else the reason
+const char *checkMessage(const char *field, const char *newValue)
+{
+  char *end;
+  long  msgId = strtol(field, &end, 10);
+  
+  if (end == field || *end != '\0')           return "not a message number";
+  if (msgId < 0 || msgId > settingLocalMaxMsg) return "out of range";
+  if (strlen(newValue) > MSG_TEXT_SIZE)         return "too long";
+  return NULL;
+  
+} // checkMessage()
+
+
 //=======================================================================
 void updateMessage(const char *field, const char *newValue)
 {
-  int8_t msgId = String(field).toInt();
+  int8_t msgId = atoi(field);
   
   DebugTf("-> field[%s], newValue[%s]\r\n", field, newValue);
 
@@ -175,33 +763,6 @@ void updateMessage(const char *field, const char *newValue)
 } // updateMessage()
 
 
-//====================================================================
-void writeToLog(const char *logLine)
-{
-  if (ESP.getFreeHeap() < 8500) // to prevent firmware from crashing!
-  {
-    DebugTf("Bailout due to low heap (%d bytes)\r\n", ESP.getFreeHeap());
-    return;
-  }
-  char buffer[150] = "";
-  snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d; %02d:%02d:%02d; %s;\n"
-                                          , year(), month(), day()
-                                          , hour(), minute(), second()
-                                          , logLine);
-  DebugTf("writeToLogs() => %s\r\n", buffer);
-  File _file = LittleFS.open("/sysLog.csv", "a");
-  if (!_file)
-  {
-    DebugTln("write(): No /sysLog.csv found ..");
-  }
-  _file.print(buffer);
-  _file.flush();
-  _file.close();
-  
-} // writeLastStatus()
-
-
-
 /***************************************************************************
 *
 * Permission is hereby granted, free of charge, to any person obtaining a
@@ -0,0 +1,183 @@
+#include "logStuff.h"
+
+/* 
+***************************************************************************  
+**  Program  : logStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.                                                            
+***************************************************************************      
+*/
+
+#include "platformStuff.h"
+#ifdef USE_TELNET
+  #include <TelnetStream.h>
+#endif
+
+extern ESP8266WebServer httpServer;
+
+logStream DebugLog;
+
+//-- logHead and logSerial count all bytes ever written/drained, the
+//-- ring holds the last LOG_RING_SIZE of them
+static char     logRing[LOG_RING_SIZE];
+static uint32_t logHead     = 0;
+static uint32_t logSerial   = 0;
+static uint32_t logLostCnt  = 0;
+static bool     logBlocking = true;   // until setup() is done
+#if defined(ESP32)
+//-- both cores write to the ring (see NET_TASK_CORE)
+static portMUX_TYPE logMux  = portMUX_INITIALIZER_UNLOCKED;
+  #define LOG_LOCK()      portENTER_CRITICAL(&logMux)
+  #define LOG_UNLOCK()    portEXIT_CRITICAL(&logMux)
+#else
+  #define LOG_LOCK()
+  #define LOG_UNLOCK()
+#endif
+
+//=======================================================================
+size_t logStream::write(uint8_t c)
+{
+  LOG_LOCK();
+  logRing[logHead & (LOG_RING_SIZE -1)] = c;
+  logHead++;
+  LOG_UNLOCK();
+  if (logBlocking) logFlush();
+  return 1;
+  
+} // logStream::write()
+
+
+//=======================================================================
+size_t logStream::write(const uint8_t *buffer, size_t size)
+{
+  LOG_LOCK();
+  for (size_t i=0; i<size; i++)
+  {
+    logRing[logHead & (LOG_RING_SIZE -1)] = buffer[i];
+    logHead++;
+  }
+  LOG_UNLOCK();
+  if (logBlocking) logFlush();
+  return size;
+  
+} // logStream::write()
+
+
+//=======================================================================
+void startTelnet()
+{
+#ifdef USE_TELNET
+  TelnetStream.begin();
+#endif
+  
+} // startTelnet()
+
+
+//=======================================================================
+//-- false: from now on the log is only sent by logDrain()
+void logSetBlocking(bool blocking)
+{
+  logBlocking = blocking;
+  if (!blocking) return;
+  logFlush();
+  
+} // logSetBlocking()
+
+
+//=======================================================================
+//-- send what Serial can take right now, call from loop()
+void logDrain()
+{
+  if ((logHead - logSerial) > LOG_RING_SIZE)
+  {
+    //-- overwritten before it could be sent
+    logLostCnt += (logHead - logSerial) - LOG_RING_SIZE;
+    logSerial   = logHead - LOG_RING_SIZE;
+  }
+  
+  uint32_t  todo  = logHead - logSerial;
+  int       room  = Serial.availableForWrite();
+  if (todo > (uint32_t)room)    todo = room;
+  if (todo > LOG_DRAIN_MAX)     todo = LOG_DRAIN_MAX;
+  
+  while (todo > 0)
+  {
+    uint16_t  pos = logSerial & (LOG_RING_SIZE -1);
+    uint16_t  len = todo;
+    if ((pos + len) > LOG_RING_SIZE) len = LOG_RING_SIZE - pos;   // wraps
+    Serial.write((const uint8_t*)&logRing[pos], len);
+#ifdef USE_TELNET
+    TelnetStream.write((const uint8_t*)&logRing[pos], len);
+#endif
+    logSerial += len;
+    todo      -= len;
+  }
+  
+} // logDrain()
+
+
+//=======================================================================
+//-- blocking: before a reboot or when loop() is not running (yet)
+void logFlush()
+{
+  while (logSerial != logHead)
+  {
+    logDrain();
+    yield();
+  }
+  Serial.flush();
+  
+} // logFlush()
+
+
+//=======================================================================
+uint32_t logLost()
+{
+  return logLostCnt;
+  
+} // logLost()
+
+
+//=======================================================================
+//-- '/api/v0/log/debug': the ring buffer (oldest first) as plain text
+void sendLogBuffer()
+{
+  uint32_t  head  = logHead;
+  uint32_t  len   = (head < LOG_RING_SIZE) ? head : LOG_RING_SIZE;
+  uint16_t  start = (head - len) & (LOG_RING_SIZE -1);
+  uint16_t  part  = ((start + len) > LOG_RING_SIZE) ? (LOG_RING_SIZE - start) : len;
+
+  httpServer.sendHeader("Access-Control-Allow-Origin", "*");
+  httpServer.setContentLength(len);
+  httpServer.send(200, "text/plain", "");
+  httpServer.sendContent(&logRing[start], part);
+  if (part < len) httpServer.sendContent(&logRing[0], len - part);
+  
+} // sendLogBuffer()
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* 
+****************************************************************************
+*/
@@ -0,0 +1,247 @@
+#include "metricsStuff.h"
+
+/* 
+***************************************************************************  
+**  Program  : metricsStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.                                                            
+***************************************************************************      
+*/
+
+#include "platformStuff.h"
+
+//-- Counters and histograms behind '/api/v0/metrics'. Recording is a few
+//-- adds per call so it can stay in the production firmware.
+static metricHisto  loopHisto;        // us, loop() start -> displayAnimate()
+static metricHisto  frameHisto;       // us, between displayAnimate() calls
+static metricHisto  gapHisto;         // us, end of one message to the start of the next
+static metricHisto  fetchHisto[FETCH_PROVIDERS];  // ms
+static uint16_t     fetchFails[FETCH_PROVIDERS];
+static metricHisto  fsReadHisto;      // us
+static metricHisto  fsWriteHisto;     // us
+
+static uint32_t     loopStartMicros   = 0;
+static uint32_t     lastFrameMicros   = 0;
+static uint32_t     heapTimer         = 0;
+static uint32_t     heapFree          = 0;
+static uint32_t     heapFreeMin       = 0xFFFFFFFF;
+static uint32_t     heapBlock         = 0;
+static uint32_t     heapBlockMin      = 0xFFFFFFFF;
+static uint8_t      heapFrag          = 0;
+static uint8_t      heapFragMax       = 0;
+
+//=======================================================================
+static void histoAdd(metricHisto *h, uint32_t value)
+{
+  uint8_t b = 0;
+  
+  //-- number of bits in value, minus the first bucket's
+  for (uint32_t v = (value >> METRIC_FIRST_SHIFT); v > 0 && b < (METRIC_BUCKETS -1); v >>= 1)
+  {
+    b++;
+  }
+  h->bucket[b]++;
+  h->count++;
+  h->sum += value;
+  if (value > h->max) h->max = value;
+  
+} // histoAdd()
+
+
+//=======================================================================
+static void sendHisto(const char *prefix, metricHisto *h)
+{
+  char fld[30];
+
+  snprintf(fld, sizeof(fld), "%scount", prefix);
+  sendNestedJsonObj(fld, h->count);
+  snprintf(fld, sizeof(fld), "%savg", prefix);
+  sendNestedJsonObj(fld, (uint32_t)(h->count ? (h->sum / h->count) : 0));
+  snprintf(fld, sizeof(fld), "%smax", prefix);
+  sendNestedJsonObj(fld, h->max);
+  snprintf(fld, sizeof(fld), "%shist", prefix);
+  sendNestedJsonArray(fld, h->bucket, METRIC_BUCKETS);
+  
+} // sendHisto()
+
+
+//=======================================================================
+static void sampleHeap()
+{
+  uint32_t  hFree;
+  uint32_t  hBlock;
+  uint8_t   hFrag;
+
+  platformHeapStats(&hFree, &hBlock, &hFrag);
+  heapFree  = hFree;
+  heapBlock = hBlock;
+  heapFrag  = hFrag;
+  if (heapFree  < heapFreeMin)  heapFreeMin  = heapFree;
+  if (heapBlock < heapBlockMin) heapBlockMin = heapBlock;
+  if (heapFrag  > heapFragMax)  heapFragMax  = heapFrag;
+  
+} // sampleHeap()
+
+
+//=======================================================================
+//-- first thing in loop()
+void metricsLoopStart()
+{
+  loopStartMicros = micros();
+  
+  if ((millis() - heapTimer) >= 1000)
+  {
+    heapTimer = millis();
+    sampleHeap();
+  }
+  
+} // metricsLoopStart()
+
+
+//=======================================================================
+//-- right before P.displayAnimate() in loop()
+void metricsFrameStart()
+{
+  uint32_t now = micros();
+  
+  histoAdd(&loopHisto, now - loopStartMicros);
+  if (lastFrameMicros != 0) histoAdd(&frameHisto, now - lastFrameMicros);
+  lastFrameMicros = now;
+  
+} // metricsFrameStart()
+
+
+//=======================================================================
+//-- from the end of one animation until the next one is started
+void metricsMessageGap(uint32_t startMicros)
+{
+  histoAdd(&gapHisto, micros() - startMicros);
+  
+} // metricsMessageGap()
+
+
+//=======================================================================
+void metricsFetchDone(uint8_t provider, uint32_t durationMs, bool ok)
+{
+  if (provider >= FETCH_PROVIDERS) return;
+  histoAdd(&fetchHisto[provider], durationMs);
+  if (!ok) fetchFails[provider]++;
+  
+} // metricsFetchDone()
+
+
+//=======================================================================
+//-- call with the micros() from before the LittleFS access
+void metricsFsOp(bool isWrite, uint32_t startMicros)
+{
+  histoAdd(isWrite ? &fsWriteHisto : &fsReadHisto, micros() - startMicros);
+  
+} // metricsFsOp()
+
+
+//=======================================================================
+void metricsReset()
+{
+  memset(&loopHisto,    0, sizeof(loopHisto));
+  memset(&frameHisto,   0, sizeof(frameHisto));
+  memset(&gapHisto,     0, sizeof(gapHisto));
+  memset(fetchHisto,    0, sizeof(fetchHisto));
+  memset(fetchFails,    0, sizeof(fetchFails));
+  memset(&fsReadHisto,  0, sizeof(fsReadHisto));
+  memset(&fsWriteHisto, 0, sizeof(fsWriteHisto));
+  lastFrameMicros = 0;
+  heapFreeMin     = 0xFFFFFFFF;
+  heapBlockMin    = 0xFFFFFFFF;
+  heapFragMax     = 0;
+  sampleHeap();
+  
+} // metricsReset()
+
+
+//=======================================================================
+void sendMetrics()
+{
+  uint32_t  bounds[METRIC_BUCKETS -1];
+  char      fld[30];
+  
+  for (uint8_t b=0; b<(METRIC_BUCKETS -1); b++)
+  {
+    bounds[b] = (uint32_t)1 << (METRIC_FIRST_SHIFT + b);
+  }
+  
+  sendStartJsonObj("metrics");
+
+  sendNestedJsonObj("uptime",       (uint32_t)(millis() / 1000));
+  sendNestedJsonArray("histbounds", bounds, METRIC_BUCKETS -1);
+  sendHisto("loopus",       &loopHisto);
+  sendHisto("frameus",      &frameHisto);
+  sendHisto("gapus",        &gapHisto);
+  for (uint8_t p=0; p<FETCH_PROVIDERS; p++)
+  {
+    snprintf(fld, sizeof(fld), "%sms", fetchProviderName(p));
+    sendHisto(fld, &fetchHisto[p]);
+    snprintf(fld, sizeof(fld), "%sfails", fetchProviderName(p));
+    sendNestedJsonObj(fld, (uint32_t)fetchFails[p]);
+    const fetchHostStats *host = fetchGetHost(p);
+    if (host == NULL) continue;
+    snprintf(fld, sizeof(fld), "%sdnsms", fetchProviderName(p));
+    sendNestedJsonObj(fld, host->dnsMs);
+    snprintf(fld, sizeof(fld), "%sconnectms", fetchProviderName(p));
+    sendNestedJsonObj(fld, host->connectMs);
+    snprintf(fld, sizeof(fld), "%smaxconnectms", fetchProviderName(p));
+    sendNestedJsonObj(fld, host->maxConnectMs);
+    snprintf(fld, sizeof(fld), "%sconnects", fetchProviderName(p));
+    sendNestedJsonObj(fld, (uint32_t)host->connects);
+    snprintf(fld, sizeof(fld), "%sreuses", fetchProviderName(p));
+    sendNestedJsonObj(fld, (uint32_t)host->reuses);
+    snprintf(fld, sizeof(fld), "%sconnectfails", fetchProviderName(p));
+    sendNestedJsonObj(fld, (uint32_t)host->connectFails);
+    snprintf(fld, sizeof(fld), "%scertfails", fetchProviderName(p));
+    sendNestedJsonObj(fld, (uint32_t)host->certFails);
+  }
+  sendHisto("fsreadus",     &fsReadHisto);
+  sendHisto("fswriteus",    &fsWriteHisto);
+
+  sendNestedJsonObj("heapfree",     heapFree);
+  sendNestedJsonObj("heapfreemin",  heapFreeMin);
+  sendNestedJsonObj("maxblock",     heapBlock);
+  sendNestedJsonObj("maxblockmin",  heapBlockMin);
+  sendNestedJsonObj("heapfrag",     (uint32_t)heapFrag);
+  sendNestedJsonObj("heapfragmax",  (uint32_t)heapFragMax);
+  sendNestedJsonObj("loglost",      logLost());
+  sendNestedJsonObj("sysloglost",   sysLogLost());
+  sendNestedJsonObj("pushviewers",  (uint32_t)pushViewers());
+  sendNestedJsonObj("pushdropped",  pushDropped());
+  sendNestedJsonObj("bootstatus",   (uint32_t)bootStatus);
+  sendNestedJsonObj("firstscrollms",firstScrollMs);
+
+  sendEndJsonObj();
+  
+} // sendMetrics()
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+* 
+****************************************************************************
+*/
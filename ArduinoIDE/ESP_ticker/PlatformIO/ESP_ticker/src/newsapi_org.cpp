@@ -12,139 +12,119 @@
 
 //-- http://newsapi.org/v2/top-headlines?country=nl&apiKey=API_KEY
 
+static jsonScanner newsScanner;
+static char        newsMessage[NEWS_SIZE];
+static int         newsMsgNr;
+static uint32_t    newsSetCrc;            // over all headlines of this fetch
+static uint32_t    lastNewsSetCrc = 0;
+
+//----------------------------------------------------------------------
+//-- called by the json scanner for every key/value in the response
+static bool onNewsEvent(jsonScanner *js, uint8_t event)
+{
+  if (event != JSON_EV_VALUE || !js->isString)  return true;
+  if (strcmp(js->key, "title") != 0)            return true;
+
+  Debugf("\t[%2d] %s\r\n", newsMsgNr, js->val);
+  if (!hasNoNoWord(js->val) && strlen(js->val) > 15)
+  {
+    newsSetCrc = calcCRC32(js->val, strlen(js->val), newsSetCrc);
+    //-- an unchanged headline is not written again, see writeFileById()
+    writeFileById("NWS", newsMsgNr, js->val);
+    newsMsgNr++;
+  }
+  //-- stop reading as soon as all slots are filled
+  return (newsMsgNr <= settingNewsMaxMsg);
+
+} // onNewsEvent()
+
+
+//----------------------------------------------------------------------
+//-- only when there is nothing (left) to show
+static void noNewsAvailable()
+{
+  for(int i=0; i<=settingNewsMaxMsg; i++)
+  {
+    if (hasMessage("NWS", i)) return;   //-- keep the last good set
+  }
+  //-- empty newsMessage store --
+  beginMessageBatch();
+  for(int i=0; i<=settingNewsMaxMsg; i++)
+  {
+    if (i==1) writeFileById("NWS", i, "There is No News ....");
+    else      writeFileById("NWS", i, "");
+  }
+  commitMessageBatch();
+
+} // noNewsAvailable()
+
+
+//----------------------------------------------------------------------
+static bool onNewsBody(const char *data, int len)
+{
+  return jsonScanFeed(&newsScanner, data, len);
+
+} // onNewsBody()
+
+
 //----------------------------------------------------------------------
+static void onNewsDone(bool ok)
+{
+  DebugTf("[%d] headlines accepted%s\r\n", newsMsgNr, (ok ? "" : ", fetch cut off"));
+  if (ok || newsMsgNr > 0)
+  {
+    if (newsMsgNr > 0)
+    {
+      //-- slots it did not fill are emptied: new and old headlines are not mixed
+      for (int n=newsMsgNr; n<=settingNewsMaxMsg; n++) writeFileById("NWS", n, "");
+    }
+    if (newsSetCrc == lastNewsSetCrc) DebugTln("headlines unchanged");
+    lastNewsSetCrc = newsSetCrc;
+    updateMessage("0", "News brought to you by 'newsapi.org'");
+    commitMessageBatch();   //-- started by getNewsapiData()
+    //-- only a complete set is a success, after a partial one it backs off and tries again
+    schedDone(SCHED_NEWS, ok);
+    return;
+  }
+  
+  if (fetchGetStats(FETCH_NEWSAPI)->httpStatus == 0)
+  {
+    sprintf(tempMessage, "connection to %s failed", "newsapi.org");
+  }
+  //-- failed: the stored headlines stay
+  noNewsAvailable();
+  schedDone(SCHED_NEWS, false);   //-- backs off with every failure
+  commitMessageBatch();   //-- started by getNewsapiData()
+
+} // onNewsDone()
+
+
+//----------------------------------------------------------------------
+//-- starts the fetch, fetchLoop() does the rest
 bool getNewsapiData() 
 {
   const char* newsapiHost    = "newsapi.org";
-  const int   httpPort       = 80;
-  int         newsapiStatus  = 0;
-  char        newsMessage[NEWS_SIZE] = {};
-  int         startPos, endPos;
-  int32_t     maxWait;
-  char        jsonResponse[1024];
-  char        val[51] = "";
-  
-  WiFiClient newsapiClient;
+  const int   httpPort       = FETCH_HTTPS_PORT;
+  char        url[FETCH_PATH_MAX];
 
   Debugln();
   DebugTf("getNewsapiData(%s)\r\n", newsapiHost);
 
   // We now create a URI for the request
-  String url = "/v2/top-headlines?country=nl&apiKey=";
-  url += settingNewsAUTH;
+  snprintf(url, sizeof(url), "/v2/top-headlines?country=nl&apiKey=%s", settingNewsAUTH);
 
   DebugTf("Requesting URL: %s/v2/top-headlines?country=nl&apiKey=secret\r\n", newsapiHost);
-  DebugFlush();
-  //Debugln("\r\n=======================================");
-  //DebugFlush();
-  //Debug(newsapiHost);
-  //Debugln(url);
-  //Debugln("=======================================");
   
-  if (!newsapiClient.connect(newsapiHost, httpPort)) 
+  newsMsgNr  = 0;
+  newsSetCrc = 0;
+  jsonScanBegin(&newsScanner, newsMessage, sizeof(newsMessage), onNewsEvent);
+  
+  if (!fetchStart(FETCH_NEWSAPI, newsapiHost, httpPort, url, onNewsBody, onNewsDone))
   {
-    DebugTln("connection failed");
-    sprintf(tempMessage, "connection to %s failed", newsapiHost);
-    //-- empty newsMessage store --
-    for(int i=0; i<=settingNewsMaxMsg; i++)
-    {
-      //sprintf(newsMessage, "");
-      if (i==1) writeFileById("NWS", i, "There is No News ....");
-      else      writeFileById("NWS", i, "");
-    }
-    
-    newsapiClient.flush();
-    newsapiClient.stop();
     return false;
   }
-
-  // This will send the request to the server
-  newsapiClient.print(String("GET ") + url + " HTTP/1.1\r\n" +
-               "Host: " + newsapiHost + "\r\n" + 
-               "User-Agent: ESP-ticker\r\n" + 
-               "Connection: close\r\n\r\n");
-  delay(10);
-  
-  newsapiClient.setTimeout(5000);
-  while (newsapiClient.connected() || newsapiClient.available())
-  {
-    yield();
-    while(newsapiClient.available())
-    {
-      Debugln();
-      //--- skip to find HTTP/1.1
-      //--- then parse response code
-      if (newsapiClient.find("HTTP/1.1"))
-      {
-        newsapiStatus = newsapiClient.parseInt(); // parse status code
-        DebugTf("Statuscode: [%d] ", newsapiStatus); 
-        if (newsapiStatus != 200)
-        {
-          Debugln(" ERROR!");
-          while(newsapiClient.available())
-          {
-            char nC = newsapiClient.read();
-            Debug(nC);
-          }
-          Debugln();
-          newsapiClient.flush();
-          newsapiClient.stop();
-          for(int i=0; i<=settingNewsMaxMsg; i++)
-          {
-            //sprintf(newsMessage, "");
-            if (i==1) writeFileById("NWS", i, "There is No News ....");
-            else      writeFileById("NWS", i, "");
-          }
-          newsapiClient.flush();
-          newsapiClient.stop();
-          return false;  
-        }
-        Debugln(" OK!");
-      }
-      else
-      {
-        DebugTln("Error reading newsapi.org.. -> bailout!");
-        for(int i=0; i<=settingNewsMaxMsg; i++)
-        {
-          //sprintf(newsMessage, "");
-          if (i==1) writeFileById("NWS", i, "There is No News ....");
-          else      writeFileById("NWS", i, "");
-        }
-        newsapiClient.flush();
-        newsapiClient.stop();
-        return false;
-      }
-      //--- skip headers
-      uint16_t  msgIdx  = 0;
-      int       msgNr   = 0;
-      while (newsapiClient.find("\"title\":\""))
-      {
-        for (int i=0; i<NEWS_SIZE; i++) newsMessage[i] = 0;
-        msgIdx          = 0;
-        while( (strIndex(newsMessage, "\"description\":") == -1) && (msgIdx < (NEWS_SIZE - 2)) )
-        {
-          newsMessage[msgIdx++] = (char)newsapiClient.read();
-        }
-        newsMessage[msgIdx] = '\0';
-        if (msgIdx > 30)  newsMessage[msgIdx - 16] = 0;
-        Debugf("\t[%2d] %s\r\n", msgNr, newsMessage);
-        if (!hasNoNoWord(newsMessage) && strlen(newsMessage) > 15)
-        {
-          if (msgNr <= settingNewsMaxMsg)
-          {
-            writeFileById("NWS", msgNr, newsMessage);
-          }
-          msgNr++;
-        }
-      } // while find(title)
-    } // while available ..
-    
-  } // connected ..
-
-  newsapiClient.flush();
-  newsapiClient.stop();
-  updateMessage("0", "News brought to you by 'newsapi.org'");
-
+  //-- all headlines go to the message store in one write, see onNewsDone()
+  beginMessageBatch();
   return true;
 
 } // getNewsapiData()
@@ -153,14 +133,13 @@ bool getNewsapiData()
 //----------------------------------------------------------------------
 void removeNewsData()
 {
-  char nwsName[15];
-
+  beginMessageBatch();
   for(int n=0; n<=settingNewsMaxMsg; n++)
   {
-    sprintf(nwsName, "/newsFiles/NWS-%03d", n);
-    DebugTf("Remove [%s] from LittleFS ..\r\n", nwsName);
-    LittleFS.remove(nwsName);
+    DebugTf("Remove [NWS-%03d] ..\r\n", n);
+    writeFileById("NWS", n, "");  //-- also clears the cached message
   }
+  commitMessageBatch();
 
 } //  removeNewsData()
 
@@ -0,0 +1,163 @@
+#include "noWordStuff.h"
+
+/*
+***************************************************************************
+**  Program  : noWordStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//=======================================================================
+//-- The newsNoWords are compiled into an Aho-Corasick automaton so a
+//-- headline is checked against all words in one pass, without copies.
+//-- Node 0 is the root, every word adds at most one node per character.
+typedef struct _noWordNode {
+  char     c;
+  uint8_t  child;     // first child, 0 = none
+  uint8_t  sibling;   // next child of the same parent, 0 = none
+  uint8_t  fail;      // longest proper suffix that is also in the tree
+} noWordNode;
+
+static noWordNode noWordTree[NO_WORD_NODES];
+static uint8_t    noWordHit[(NO_WORD_NODES +7) / 8];   // bit set: a word ends here
+static uint8_t    noWordNodes = 1;
+
+#define NOWORD_HIT(n)     (noWordHit[(n) >> 3] & (1 << ((n) & 7)))
+#define NOWORD_SETHIT(n)  (noWordHit[(n) >> 3] |= (1 << ((n) & 7)))
+
+//=======================================================================
+static inline char foldChar(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? (c + 32) : c;
+  
+} // foldChar()
+
+//=======================================================================
+static uint8_t noWordChild(uint8_t node, char c)
+{
+  for (uint8_t n = noWordTree[node].child; n != 0; n = noWordTree[n].sibling)
+  {
+    if (noWordTree[n].c == c) return n;
+  }
+  return 0;
+  
+} // noWordChild()
+
+//=======================================================================
+void splitNewsNoWords(const char *noNo)
+{
+  uint8_t queue[NO_WORD_NODES];
+  uint8_t qHead = 0, qTail = 0;
+  int     wc = 0;
+  
+  DebugTln(noNo);
+  memset(noWordTree, 0, sizeof(noWordTree));
+  memset(noWordHit,  0, sizeof(noWordHit));
+  noWordNodes = 1;
+
+  //-- words are separated by spaces (or comma's), one letter words are skipped
+  for (int p=0; noNo[p] != '\0'; )
+  {
+    while (noNo[p] == ' ' || noNo[p] == ',') p++;
+    int wStart = p;
+    while (noNo[p] != '\0' && noNo[p] != ' ' && noNo[p] != ',') p++;
+    if ((p - wStart) < 2) continue;
+
+    uint8_t node = 0;
+    for (int i=wStart; (i<p && node != NO_WORD_NODES); i++)
+    {
+      char    c    = foldChar(noNo[i]);
+      uint8_t next = noWordChild(node, c);
+      if (next == 0)
+      {
+        if (noWordNodes >= NO_WORD_NODES) 
+        {
+          DebugTln("too many NoNoWords!");
+          node = NO_WORD_NODES;
+          break;
+        }
+        next = noWordNodes++;
+        noWordTree[next].c       = c;
+        noWordTree[next].sibling = noWordTree[node].child;
+        noWordTree[node].child   = next;
+      }
+      node = next;
+    }
+    if (node == NO_WORD_NODES) break;
+    NOWORD_SETHIT(node);
+    DebugTf("NoNoWord[%d] [%.*s]\r\n", wc++, (p - wStart), &noNo[wStart]);
+  }
+
+  //-- breadth first: set the fail links, a node also hits if its fail node does
+  for (uint8_t n = noWordTree[0].child; n != 0; n = noWordTree[n].sibling)
+  {
+    noWordTree[n].fail = 0;
+    queue[qTail++] = n;
+  }
+  while (qHead < qTail)
+  {
+    uint8_t node = queue[qHead++];
+    for (uint8_t n = noWordTree[node].child; n != 0; n = noWordTree[n].sibling)
+    {
+      uint8_t f = noWordTree[node].fail;
+      while (f != 0 && noWordChild(f, noWordTree[n].c) == 0) f = noWordTree[f].fail;
+      noWordTree[n].fail = noWordChild(f, noWordTree[n].c);
+      if (NOWORD_HIT(noWordTree[n].fail)) NOWORD_SETHIT(n);
+      queue[qTail++] = n;
+    }
+  }
+  DebugTf("[%d] NoNoWords use [%d] nodes\r\n", wc, noWordNodes);
+  
+} // splitNewsNoWords()
+
+//=======================================================================
+bool hasNoNoWord(const char *cIn)
+{
+  uint8_t node = 0;
+  
+  for (const char *p = cIn; *p != '\0'; p++)
+  {
+    char    c = foldChar(*p);
+    uint8_t next;
+    while ((next = noWordChild(node, c)) == 0 && node != 0) node = noWordTree[node].fail;
+    node = next;
+    if (NOWORD_HIT(node))  // yes! it's in there somewhere
+    {
+      DebugTf("found NoNoWord in [%s]\r\n", cIn);
+      return true;      
+    }
+  }
+  //DebugTln("no NoNo words found!");
+  return false;
+  
+} // hasNoNoWord()
+
+
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
@@ -0,0 +1,241 @@
+#include "platformStuff.h"
+
+/*
+***************************************************************************
+**  Program  : platformStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- What the ESP8266 core ([env:esp12eDev], [env:esp12eProd]) and the
+//-- ESP32 core ([env:esp32]) do differently, the rest of the firmware
+//-- only uses these. The webserver is ESP8266WebServer in both, on the
+//-- ESP32 that is a typedef of WebServer (see allDefines.h).
+
+#if defined(ESP32)
+  #include <esp_system.h>
+#endif
+
+
+//=======================================================================
+fsDir::fsDir(const char *path)
+#if defined(ESP32)
+  : dir(LittleFS.open(path))
+#else
+  : dir(LittleFS.openDir(path))
+#endif
+{
+} // fsDir()
+
+
+//=======================================================================
+bool fsDir::next()
+{
+#if defined(ESP32)
+  if (!dir || !dir.isDirectory()) return false;
+  entry = dir.openNextFile();     //-- closes the one before
+  return (bool)entry;
+#else
+  return dir.next();
+#endif
+
+} // fsDir::next()
+
+
+//=======================================================================
+String fsDir::fileName()
+{
+#if defined(ESP32)
+  //-- older ESP32 cores give the full path
+  String name = entry.name();
+  return name.substring(name.lastIndexOf('/') +1);
+#else
+  return dir.fileName();
+#endif
+
+} // fsDir::fileName()
+
+
+//=======================================================================
+uint32_t fsDir::fileSize()
+{
+#if defined(ESP32)
+  return entry.size();
+#else
+  return dir.fileSize();
+#endif
+
+} // fsDir::fileSize()
+
+
+//=======================================================================
+bool fsDir::isDirectory()
+{
+#if defined(ESP32)
+  return entry.isDirectory();
+#else
+  return dir.isDirectory();
+#endif
+
+} // fsDir::isDirectory()
+
+
+//=======================================================================
+uint32_t platformChipId()
+{
+#if defined(ESP32)
+  return (uint32_t)(ESP.getEfuseMac() >> 24);   //-- the last 3 bytes of the MAC
+#else
+  return ESP.getChipId();
+#endif
+
+} // platformChipId()
+
+
+//=======================================================================
+uint32_t platformMaxFreeBlock()
+{
+#if defined(ESP32)
+  return ESP.getMaxAllocHeap();
+#else
+  return ESP.getMaxFreeBlockSize();
+#endif
+
+} // platformMaxFreeBlock()
+
+
+//=======================================================================
+//-- free heap, largest block and fragmentation (%)
+void platformHeapStats(uint32_t *hFree, uint32_t *hBlock, uint8_t *hFrag)
+{
+#if defined(ESP32)
+  *hFree  = ESP.getFreeHeap();
+  *hBlock = ESP.getMaxAllocHeap();
+  *hFrag  = (*hFree > 0) ? 100 - (uint8_t)(((uint64_t)*hBlock * 100) / *hFree) : 0;
+#else
+  uint16_t block;
+  ESP.getHeapStats(hFree, &block, hFrag);
+  *hBlock = block;
+#endif
+
+} // platformHeapStats()
+
+
+//=======================================================================
+String platformResetReason()
+{
+#if defined(ESP32)
+  switch(esp_reset_reason())
+  {
+    case ESP_RST_POWERON:   return F("Power on");
+    case ESP_RST_EXT:       return F("External System");
+    case ESP_RST_SW:        return F("Software/System restart");
+    case ESP_RST_PANIC:     return F("Exception");
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:       return F("Watchdog");
+    case ESP_RST_DEEPSLEEP: return F("Deep-Sleep Wake");
+    case ESP_RST_BROWNOUT:  return F("Brownout");
+    default:                return F("Unknown");
+  }
+#else
+  return ESP.getResetReason();
+#endif
+
+} // platformResetReason()
+
+
+//=======================================================================
+uint32_t platformFsTotal()
+{
+#if defined(ESP32)
+  return LittleFS.totalBytes();
+#else
+  FSInfo LittleFSinfo;
+  LittleFS.info(LittleFSinfo);
+  return LittleFSinfo.totalBytes;
+#endif
+
+} // platformFsTotal()
+
+
+//=======================================================================
+uint32_t platformFsUsed()
+{
+#if defined(ESP32)
+  return LittleFS.usedBytes();
+#else
+  FSInfo LittleFSinfo;
+  LittleFS.info(LittleFSinfo);
+  return LittleFSinfo.usedBytes;
+#endif
+
+} // platformFsUsed()
+
+
+//=======================================================================
+//-- before WiFi.begin()
+void platformSetHostname(const char *hostname)
+{
+#if defined(ESP32)
+  WiFi.setHostname(hostname);
+#else
+  WiFi.hostname(hostname);
+#endif
+
+} // platformSetHostname()
+
+
+//=======================================================================
+//-- a new settingHostname
+void platformMdnsHostname(const char *hostname)
+{
+#if defined(ESP32)
+  if (!WiFi.isConnected()) return;    //-- startMDNS() will use it
+  MDNS.end();
+  if (MDNS.begin(hostname)) MDNS.addService("http", "tcp", 80);
+#else
+  MDNS.setHostname(hostname);
+#endif
+
+} // platformMdnsHostname()
+
+
+//=======================================================================
+//-- call from loop(), the ESP32 mDNS responder runs in a task of its own
+void platformMdnsLoop()
+{
+#if !defined(ESP32)
+  MDNS.update();
+#endif
+
+} // platformMdnsLoop()
+
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
@@ -0,0 +1,167 @@
+#include "playlistStuff.h"
+
+/*
+***************************************************************************
+**  Program  : playlistStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- The order in which the sources are shown. Every source has a weight
+//-- in settingPlayWeight[] (0 = never). playlistBuild() spreads them over
+//-- playOrder[] with a smooth weighted round robin, so news with weight 5
+//-- is not shown five times in a row, and playlistNext() only steps
+//-- through it. Urgent local messages are not in the order, they go in
+//-- front of it at least every PLAY_URGENT_EVERY items.
+
+static const char *sourceName[PLAY_SOURCES +1] = { "clock", "local", "news", "weather", "urgent" };
+
+static uint8_t  playOrder[PLAYLIST_MAX];
+static uint8_t  playLen      = 0;
+static uint8_t  playPos      = 0;
+static uint8_t  sinceUrgent  = 0;
+static bool     urgentNow    = false;
+
+
+//=======================================================================
+//-- after a change of settingPlayWeight[]
+void playlistBuild()
+{
+  int16_t current[PLAY_SOURCES];
+  int16_t total = 0;
+  
+  for (uint8_t s=0; s<PLAY_SOURCES; s++)
+  {
+    current[s] = 0;
+    total     += settingPlayWeight[s];
+  }
+  playLen = 0;
+  for (int16_t n=0; n<total && playLen<PLAYLIST_MAX; n++)
+  {
+    int8_t best = -1;
+    for (uint8_t s=0; s<PLAY_SOURCES; s++)
+    {
+      if (settingPlayWeight[s] == 0) continue;
+      current[s] += settingPlayWeight[s];
+      if (best < 0 || current[s] > current[best]) best = s;
+    }
+    current[best] -= total;
+    playOrder[playLen++] = best;
+  }
+  //-- all weights 0: the local messages only
+  if (playLen == 0) playOrder[playLen++] = PLAY_LOCAL;
+  playPos = 0;
+  DebugTf("playlist has [%d] entries\r\n", playLen);
+  
+} // playlistBuild()
+
+
+//=======================================================================
+//-- the source of the next item
+uint8_t playlistNext(bool haveUrgent)
+{
+  if (haveUrgent && (urgentNow || ++sinceUrgent >= PLAY_URGENT_EVERY))
+  {
+    urgentNow   = false;
+    sinceUrgent = 0;
+    return PLAY_URGENT;
+  }
+  urgentNow = false;
+  
+  uint8_t src = playOrder[playPos];
+  if (++playPos >= playLen) playPos = 0;
+  return src;
+  
+} // playlistNext()
+
+
+//=======================================================================
+//-- a new urgent message, it is the next item
+void playlistInterrupt()
+{
+  urgentNow = true;
+  
+} // playlistInterrupt()
+
+bool playlistInterrupted()
+{
+  return urgentNow;
+  
+} // playlistInterrupted()
+
+
+//=======================================================================
+uint8_t playlistLength()
+{
+  return playLen;
+  
+} // playlistLength()
+
+uint8_t playlistEntry(uint8_t pos)
+{
+  return (pos < playLen) ? playOrder[pos] : PLAY_NONE;
+  
+} // playlistEntry()
+
+
+//=======================================================================
+const char *playlistSourceName(uint8_t src)
+{
+  return (src <= PLAY_URGENT) ? sourceName[src] : "none";
+  
+} // playlistSourceName()
+
+//-- -1 if name is not a source with a weight
+int8_t playlistSource(const char *name)
+{
+  for (uint8_t s=0; s<PLAY_SOURCES; s++)
+  {
+    if (!stricmp(name, sourceName[s])) return s;
+  }
+  return -1;
+  
+} // playlistSource()
+
+
+//=======================================================================
+//-- the first set bit in slots after bit 'after' (wraps), -1 if none
+int8_t nextMessageSlot(uint32_t slots, int8_t after)
+{
+  if (slots == 0) return -1;
+  
+  uint32_t later = slots;
+  if (after >= 31)      later = 0;
+  else if (after >= 0)  later = slots & ~((2UL << after) -1);
+  return __builtin_ctz((later != 0) ? later : slots);
+  
+} // nextMessageSlot()
+
+
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
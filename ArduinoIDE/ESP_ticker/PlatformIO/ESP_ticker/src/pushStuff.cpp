@@ -0,0 +1,210 @@
+#include "pushStuff.h"
+
+/*
+***************************************************************************
+**  Program  : pushStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+#include "platformStuff.h"
+#include <ezTime.h>
+#include "jsonStuff.h"
+#include "settingStuff.h"
+#include "littlefsStuff.h"
+
+extern ESP8266WebServer httpServer;
+
+//-- Server-Sent Events on '/api/v0/events'. The web page loads everything
+//-- once with the REST calls and then only gets what changes:
+//--    event "message"  the text that is now on the display
+//--    event "time"     the date and time, once a minute
+//--    event "setting"  a setting that was changed
+//--    event "local"    a local message that was changed
+//-- The connection of every viewer is kept open. An event is formatted
+//-- once and the same bytes are written to all viewers; a viewer that
+//-- cannot take them right now misses the event.
+
+static WiFiClient viewer[PUSH_VIEWERS];
+static bool       inUse[PUSH_VIEWERS];
+static bool       displayChanged  = false;
+static int8_t     lastMinute      = -1;
+static uint32_t   keepAliveTimer  = 0;
+static uint32_t   droppedCnt      = 0;
+
+
+//=======================================================================
+//-- the jsonSink all events go to
+static void pushWrite(const char *data, uint16_t len)
+{
+  for (uint8_t v=0; v<PUSH_VIEWERS; v++)
+  {
+    if (!inUse[v]) continue;
+    if (!viewer[v].connected())
+    {
+      DebugTf("viewer [%d] is gone\r\n", v);
+      viewer[v].stop();
+      viewer[v] = WiFiClient();     //-- frees the connection
+      inUse[v]  = false;
+      continue;
+    }
+#if !defined(ESP32)
+    //-- the ESP32 core can not tell, its write() waits a bit instead (in
+    //-- the network task, the display goes on)
+    if (viewer[v].availableForWrite() < len)
+    {
+      droppedCnt++;
+      continue;
+    }
+#endif
+    viewer[v].write((const uint8_t*)data, len);
+  }
+
+} // pushWrite()
+
+
+//=======================================================================
+uint8_t pushViewers()
+{
+  uint8_t n = 0;
+  
+  for (uint8_t v=0; v<PUSH_VIEWERS; v++)
+  {
+    if (inUse[v] && viewer[v].connected()) n++;
+  }
+  return n;
+
+} // pushViewers()
+
+
+//=======================================================================
+uint32_t pushDropped()
+{
+  return droppedCnt;
+
+} // pushDropped()
+
+
+//=======================================================================
+//-- '/api/v0/events': the connection stays open, the headers are
+//-- written by hand so the httpServer does not use chunked encoding
+void pushSubscribe()
+{
+  int8_t slot = -1;
+  
+  for (uint8_t v=0; v<PUSH_VIEWERS && slot<0; v++)
+  {
+    if (!inUse[v] || !viewer[v].connected()) slot = v;
+  }
+  if (slot < 0)
+  {
+    httpServer.send(503, "text/plain", "503: too many viewers\r\n");
+    return;
+  }
+  
+  viewer[slot].stop();
+  viewer[slot] = httpServer.client();
+  viewer[slot].setNoDelay(true);
+  inUse[slot] = true;
+  httpServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  httpServer.sendContent("HTTP/1.1 200 OK\r\n"
+                         "Content-Type: text/event-stream\r\n"
+                         "Cache-Control: no-cache\r\n"
+                         "Connection: keep-alive\r\n"
+                         "Access-Control-Allow-Origin: *\r\n\r\n"
+                         "retry: 5000\n\n");
+  displayChanged = true;      //-- the new viewer gets what is on the display
+  IPAddress from = viewer[slot].remoteIP();
+  InfoTf("viewer [%d] from [%d.%d.%d.%d]\r\n", slot, from[0], from[1], from[2], from[3]);
+
+} // pushSubscribe()
+
+
+//=======================================================================
+//-- called by showNextMessage(), the text goes out from pushLoop()
+void pushDisplayed()
+{
+  displayChanged = true;
+
+} // pushDisplayed()
+
+
+//=======================================================================
+//-- called from loop(): sends what changed since the last call. The
+//-- changes are collected even without viewers, so they are dropped
+//-- here as well.
+void pushLoop()
+{
+  const char *name;
+  char        value[LOCAL_SIZE];
+  char        id[4];
+  int8_t      mId;
+  bool        anyone = (pushViewers() > 0);
+  
+  while (nextChangedSetting(&name, value, sizeof(value)))
+  {
+    if (anyone) sendJsonEvent(pushWrite, "setting", name, value, false);
+  }
+  while ((mId = nextChangedMessage()) >= 0)
+  {
+    //-- LCL-000 is not on the web page (and reading it removes it)
+    if (!anyone || mId == 0 || mId > settingLocalMaxMsg) continue;
+    readFileById("LCL", mId);
+    snprintf(id, sizeof(id), "%d", mId);
+    sendJsonEvent(pushWrite, "local", id, fileMessage, true);
+  }
+  if (!anyone)
+  {
+    displayChanged = false;
+    return;
+  }
+
+  if (displayChanged)
+  {
+    displayChanged = false;
+    sendJsonEvent(pushWrite, "message", "message", actMessage, true);
+  }
+  if (timeStatus() == timeSet && minute() != lastMinute)
+  {
+    lastMinute = minute();
+    snprintf(value, sizeof(value), "%04d-%02d-%02d %02d:%02d", year(), month(), day()
+                                                             , hour(), minute());
+    sendJsonEvent(pushWrite, "time", "dateTime", value, false);
+  }
+  if ((millis() - keepAliveTimer) > PUSH_KEEPALIVE)
+  {
+    keepAliveTimer = millis();
+    pushWrite(":\n\n", 3);    //-- also finds viewers that are gone
+  }
+
+} // pushLoop()
+
+
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
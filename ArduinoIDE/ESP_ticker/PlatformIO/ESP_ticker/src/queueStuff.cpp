@@ -0,0 +1,139 @@
+#include "queueStuff.h"
+
+/*
+***************************************************************************
+**  Program  : queueStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- The hand-off between the side that prepares messages (playlist,
+//-- message store, weather) and the side that shows them. It is a
+//-- single-producer/single-consumer ring without locks: queueHead is only
+//-- written by the producer, queueTail only by the consumer, and the
+//-- acquire/release order makes sure a published text is complete before
+//-- the other side sees it. No copies, the consumer shows queueRead(0)
+//-- directly and only releases it when it shows the next one, so with
+//-- QUEUE_PREPARED 2 there is one on the display and one prepared. On the
+//-- ESP32 the producer is networkTask() on NET_TASK_CORE and the consumer
+//-- loop() on the other core. An urgent message that cuts in is handed
+//-- over the same way: the producer drops its prepared entry (the
+//-- consumer skips it) and publishes the urgent one with cutIn set, so
+//-- the consumer only ever releases what it has read.
+
+static queuedMsg  queueBuf[QUEUE_DEPTH];
+static uint32_t   queueHead = 0;      // published, free running
+static uint32_t   queueTail = 0;      // released, free running
+
+
+//=======================================================================
+//-- producer: the entry to fill, NULL when the queue is full
+queuedMsg *queueWrite()
+{
+  uint32_t tail = __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE);
+
+  if ((queueHead - tail) >= QUEUE_DEPTH) return NULL;
+  __atomic_store_n(&queueBuf[queueHead % QUEUE_DEPTH].dropped, false, __ATOMIC_RELAXED);
+  return &queueBuf[queueHead % QUEUE_DEPTH];
+
+} // queueWrite()
+
+
+//=======================================================================
+//-- producer: the entry from queueWrite() is ready
+void queuePublish()
+{
+  __atomic_store_n(&queueHead, queueHead +1, __ATOMIC_RELEASE);
+
+} // queuePublish()
+
+
+//=======================================================================
+//-- consumer: the n-th published entry (0 = oldest), NULL if not there
+queuedMsg *queueRead(uint8_t n)
+{
+  uint32_t head = __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE);
+
+  if ((head - queueTail) <= n) return NULL;
+  return &queueBuf[(queueTail + n) % QUEUE_DEPTH];
+
+} // queueRead()
+
+
+//=======================================================================
+//-- consumer: done with queueRead(0), the producer may reuse it
+void queueRelease()
+{
+  if (__atomic_load_n(&queueHead, __ATOMIC_ACQUIRE) == queueTail) return;
+  __atomic_store_n(&queueTail, queueTail +1, __ATOMIC_RELEASE);
+
+} // queueRelease()
+
+
+//=======================================================================
+uint8_t queueCount()
+{
+  return __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE)
+       - __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE);
+
+} // queueCount()
+
+
+//=======================================================================
+//-- producer: the last published entry, NULL if there is none (it may
+//-- be on the display already)
+queuedMsg *queueNewest()
+{
+  if (queueHead == __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE)) return NULL;
+  return &queueBuf[(queueHead -1) % QUEUE_DEPTH];
+
+} // queueNewest()
+
+
+//=======================================================================
+//-- producer: a published entry that is not to be shown any more, the
+//-- consumer skips it when it gets there (no effect once it is shown)
+void queueDrop(queuedMsg *msg)
+{
+  __atomic_store_n(&msg->dropped, true, __ATOMIC_RELEASE);
+
+} // queueDrop()
+
+
+//=======================================================================
+//-- consumer
+bool queueDropped(queuedMsg *msg)
+{
+  return __atomic_load_n(&msg->dropped, __ATOMIC_ACQUIRE);
+
+} // queueDropped()
+
+
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
@@ -11,89 +11,136 @@
 */
 
 
+//-- route handlers get the path words after '/api/v0/<route>'
+//-----------------------------------------------------------------------
+static void apiDevInfo(uint8_t argc, char *argv[])      { sendDeviceInfo(); }
+static void apiDevTime(uint8_t argc, char *argv[])      { sendDeviceTime(); }
+static void apiGetSettings(uint8_t argc, char *argv[])  { sendDeviceSettings(); }
+static void apiPutSettings(uint8_t argc, char *argv[])  { postSettings(); }
+static void apiGetMessages(uint8_t argc, char *argv[])  { sendLocalMessages(); }
+static void apiPutMessages(uint8_t argc, char *argv[])  { postMessages(); }
+static void apiGetNews(uint8_t argc, char *argv[])      { sendNewsMessages(); }
+static void apiGetPlaylist(uint8_t argc, char *argv[])  { sendPlaylist(); }
+static void apiPutPlaylist(uint8_t argc, char *argv[])  { postPlaylist(); }
+static void apiGetEvents(uint8_t argc, char *argv[])    { pushSubscribe(); }
+
+//-----------------------------------------------------------------------
+//-- 'log' is the system log, 'log/debug' the RAM debug ring
+static void apiGetLog(uint8_t argc, char *argv[])
+{
+  if (argc > 0 && strcmp(argv[0], "debug") == 0)  sendLogBuffer();
+  else                                            sendSysLog();
+  
+} // apiGetLog()
+
+
+//-----------------------------------------------------------------------
+static void apiGetMetrics(uint8_t argc, char *argv[])
+{
+  if (argc > 0 && strcmp(argv[0], "reset") == 0) metricsReset();
+  sendMetrics();
+  
+} // apiGetMetrics()
+
+
+//-----------------------------------------------------------------------
+//-- the hash is computed by the compiler, a lookup compares method and
+//-- hash and only the matching entry does a strcmp()
+#define API_ROUTE(m, p, h)  { m, apiHash(p), p, h }
+
+static const apiRoute apiRoutes[] = {
+    API_ROUTE(HTTP_GET, "devinfo",  apiDevInfo)
+  , API_ROUTE(HTTP_GET, "devtime",  apiDevTime)
+  , API_ROUTE(HTTP_GET, "settings", apiGetSettings)
+  , API_ROUTE(HTTP_PUT, "settings", apiPutSettings)
+  , API_ROUTE(HTTP_GET, "messages", apiGetMessages)
+  , API_ROUTE(HTTP_PUT, "messages", apiPutMessages)
+  , API_ROUTE(HTTP_GET, "news",     apiGetNews)
+  , API_ROUTE(HTTP_GET, "playlist", apiGetPlaylist)
+  , API_ROUTE(HTTP_PUT, "playlist", apiPutPlaylist)
+  , API_ROUTE(HTTP_GET, "events",   apiGetEvents)
+  , API_ROUTE(HTTP_GET, "log",      apiGetLog)
+  , API_ROUTE(HTTP_GET, "metrics",  apiGetMetrics)
+};
+
+
+//-----------------------------------------------------------------------
+//-- splits path in place on '/', returns the number of words or -1
+//-- when there are more than maxWords
+static int8_t splitPath(char *path, char *word[], uint8_t maxWords)
+{
+  uint8_t n = 0;
+  char   *p = path;
+
+  while (*p)
+  {
+    while (*p == '/') p++;
+    if (*p == '\0')    break;
+    if (n == maxWords) return -1;
+    word[n++] = p;
+    while (*p && *p != '/') p++;
+    if (*p) *p++ = '\0';
+  }
+  return n;
+  
+} // splitPath()
+
+
 //=======================================================================
 void processAPI() 
 {
-  char fName[40] = "";
-  char URI[50]   = "";
-  String words[10];
+  char      URI[API_URI_MAX];
+  char     *words[API_MAX_WORDS];
+  HTTPMethod method = httpServer.method();
 
-  strncpy( URI, httpServer.uri().c_str(), sizeof(URI) );
+  if (method == HTTP_POST) method = HTTP_PUT;   //-- same handlers
+  
+  strCopy(URI, sizeof(URI), httpServer.uri().c_str());
 
-  if (httpServer.method() == HTTP_GET)
-        DebugTf("from[%s] URI[%s] method[GET] \r\n"
-                                  , httpServer.client().remoteIP().toString().c_str()
-                                        , URI); 
-  else  DebugTf("from[%s] URI[%s] method[PUT] \r\n" 
-                                  , httpServer.client().remoteIP().toString().c_str()
-                                        , URI); 
+  IPAddress from = httpServer.client().remoteIP();
+  DebugTf("from[%d.%d.%d.%d] URI[%s] method[%s] \r\n", from[0], from[1], from[2], from[3]
+                                              , URI, (method == HTTP_GET) ? "GET" : "PUT"); 
 
   if (ESP.getFreeHeap() < 8500) // to prevent firmware from crashing!
   {
-    DebugTf("==> Bailout due to low heap (%d bytes))\r\n", ESP.getFreeHeap() );
+    ErrorTf("==> Bailout due to low heap (%d bytes))\r\n", ESP.getFreeHeap() );
     httpServer.send(500, "text/plain", "500: internal server error (low heap)\r\n"); 
     return;
   }
 
-  int8_t wc = splitString(URI, '/', words, 10);
+  int8_t wc = splitPath(URI, words, API_MAX_WORDS);
   
   if (Verbose) 
   {
     DebugT(">>");
     for (int w=0; w<wc; w++)
     {
-      Debugf("word[%d] => [%s], ", w, words[w].c_str());
+      Debugf("word[%d] => [%s], ", w, words[w]);
     }
     Debugln(" ");
   }
 
-  if (words[1] != "api")
+  //-- words[] point into URI, refill it for sendApiNotFound()
+  if (wc < 3 || strcmp(words[0], "api") != 0 || strcmp(words[1], "v0") != 0)
   {
+    strCopy(URI, sizeof(URI), httpServer.uri().c_str());
     sendApiNotFound(URI);
     return;
   }
 
-  if (words[2] != "v0")
+  uint32_t hash = apiHash(words[2]);
+  for (uint8_t r=0; r<(sizeof(apiRoutes) / sizeof(apiRoutes[0])); r++)
   {
-    sendApiNotFound(URI);
-    return;
-  }
-
-  if (words[3] == "devinfo")
-  {
-    sendDeviceInfo();
-  }
-  else if (words[3] == "devtime")
-  {
-    sendDeviceTime();
-  }
-  else if (words[3] == "settings")
-  {
-    if (httpServer.method() == HTTP_PUT || httpServer.method() == HTTP_POST)
-    {
-      postSettings();
-    }
-    else
+    if (apiRoutes[r].pathHash == hash && apiRoutes[r].method == method
+                                      && strcmp(apiRoutes[r].path, words[2]) == 0)
     {
-      sendDeviceSettings();
+      apiRoutes[r].handler(wc -3, &words[3]);
+      return;
     }
   }
-  else if (words[3] == "messages")
-  {
-    if (httpServer.method() == HTTP_PUT || httpServer.method() == HTTP_POST)
-    {
-      postMessages();
-    }
-    else
-    {
-      sendLocalMessages();
-    }
-  }
-  else if (words[3] == "news")
-  {
-    sendNewsMessages();
-  }
-  else sendApiNotFound(URI);
+  
+  strCopy(URI, sizeof(URI), httpServer.uri().c_str());
+  sendApiNotFound(URI);
   
 } // processAPI()
 
@@ -109,30 +156,49 @@ void sendDeviceInfo()
   snprintf(cMsg, sizeof(cMsg), "%s %s", __DATE__, __TIME__);
   sendNestedJsonObj("compiled", cMsg);
   sendNestedJsonObj("hostname", settingHostname);
-  sendNestedJsonObj("ipaddress", WiFi.localIP().toString().c_str());
-  sendNestedJsonObj("macaddress", WiFi.macAddress().c_str());
+  IPAddress ip = WiFi.localIP();
+  snprintf(cMsg, sizeof(cMsg), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
+  sendNestedJsonObj("ipaddress", cMsg);
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  snprintf(cMsg, sizeof(cMsg), "%02X:%02X:%02X:%02X:%02X:%02X"
+                              , mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  sendNestedJsonObj("macaddress", cMsg);
   sendNestedJsonObj("freeheap", ESP.getFreeHeap());
-  sendNestedJsonObj("maxfreeblock", ESP.getMaxFreeBlockSize());
-  sendNestedJsonObj("chipid", String( ESP.getChipId(), HEX ).c_str());
-  sendNestedJsonObj("coreversion", String( ESP.getCoreVersion() ).c_str() );
-  sendNestedJsonObj("sdkversion", String( ESP.getSdkVersion() ).c_str());
+  sendNestedJsonObj("maxfreeblock", platformMaxFreeBlock());
+  snprintf(cMsg, sizeof(cMsg), "%x", platformChipId());
+  sendNestedJsonObj("chipid", cMsg);
+#if defined(ESP32)
+  snprintf(cMsg, sizeof(cMsg), "%d.%d.%d", ESP_ARDUINO_VERSION_MAJOR, ESP_ARDUINO_VERSION_MINOR
+                                         , ESP_ARDUINO_VERSION_PATCH);
+  sendNestedJsonObj("coreversion", cMsg);
+#else
+  sendNestedJsonObj("coreversion", ESP.getCoreVersion());
+#endif
+  sendNestedJsonObj("sdkversion", ESP.getSdkVersion());
   sendNestedJsonObj("cpufreq", ESP.getCpuFreqMHz());
   sendNestedJsonObj("sketchsize", formatFloat( (ESP.getSketchSize() / 1024.0), 3));
   sendNestedJsonObj("freesketchspace", formatFloat( (ESP.getFreeSketchSpace() / 1024.0), 3));
 
+#if defined(ESP32)
+  sendNestedJsonObj("flashchipsize", formatFloat((ESP.getFlashChipSize() / 1024.0 / 1024.0), 3));
+#else
   snprintf(cMsg, sizeof(cMsg), "%08X", ESP.getFlashChipId());
   sendNestedJsonObj("flashchipid", cMsg);  // flashChipId
   sendNestedJsonObj("flashchipsize", formatFloat((ESP.getFlashChipSize() / 1024.0 / 1024.0), 3));
   sendNestedJsonObj("flashchiprealsize", formatFloat((ESP.getFlashChipRealSize() / 1024.0 / 1024.0), 3));
+#endif
 
-  LittleFS.info(LittleFSinfo);
-  sendNestedJsonObj("spiffssize", formatFloat( (LittleFSinfo.totalBytes / (1024.0 * 1024.0)), 0));
+  sendNestedJsonObj("spiffssize", formatFloat( (platformFsTotal() / (1024.0 * 1024.0)), 0));
 
   sendNestedJsonObj("flashchipspeed", formatFloat((ESP.getFlashChipSpeed() / 1000.0 / 1000.0), 0));
 
   FlashMode_t ideMode = ESP.getFlashChipMode();
-  sendNestedJsonObj("flashchipmode", flashMode[ideMode]);
+  sendNestedJsonObj("flashchipmode", flashMode[(ideMode <= FM_DOUT) ? ideMode : FM_DOUT +1]);
   sendNestedJsonObj("boardtype",
+#ifdef ARDUINO_ESP32_DEV
+     "ESP32_DEV"
+#endif
 #ifdef ARDUINO_ESP8266_NODEMCU
      "ESP8266_NODEMCU"
 #endif
@@ -152,7 +218,22 @@ void sendDeviceInfo()
 
   sendNestedJsonObj("lastreset", lastReset);
 
-  httpServer.sendContent("\r\n]}\r\n");
+  //-- status and latency of the last fetch per provider
+  for (uint8_t p=0; p<FETCH_PROVIDERS; p++)
+  {
+    const fetchStats *stat = fetchGetStats(p);
+    char  fld[30];
+    snprintf(fld, sizeof(fld), "%sstatus", fetchProviderName(p));
+    sendNestedJsonObj(fld, (int32_t)stat->httpStatus);
+    snprintf(fld, sizeof(fld), "%sfetchms", fetchProviderName(p));
+    sendNestedJsonObj(fld, stat->duration);
+    snprintf(fld, sizeof(fld), "%sfetchok", fetchProviderName(p));
+    sendNestedJsonObj(fld, (uint32_t)stat->okCount);
+    snprintf(fld, sizeof(fld), "%sfetchfail", fetchProviderName(p));
+    sendNestedJsonObj(fld, (uint32_t)stat->failCount);
+  }
+
+  sendEndJsonObj();
 
 } // sendDeviceInfo()
 
@@ -185,6 +266,8 @@ void sendDeviceSettings()
   sendJsonSettingObj("textSpeed",         settingTextSpeed,        "i",  10, MAX_SPEED);
   sendJsonSettingObj("LDRlowOffset",      settingLDRlowOffset,     "i",   0,  500);
   sendJsonSettingObj("LDRhighOffset",     settingLDRhighOffset,    "i", 500, 1024);
+  sendJsonSettingObj("LDRsampleTime",     settingLDRsampleTime,    "i",  50, 5000);
+  sendJsonSettingObj("LDRsmoothing",      settingLDRsmoothing,     "i",   1,   50);
   sendJsonSettingObj("maxIntensity",      settingMaxIntensity,     "i",   0,   15);
   sendJsonSettingObj("weerliveAUTH",      settingWeerLiveAUTH,     "s", sizeof(settingWeerLiveAUTH) -1);
   sendJsonSettingObj("weerliveLocation",  settingWeerLiveLocation, "s", sizeof(settingWeerLiveLocation) -1);
@@ -193,6 +276,12 @@ void sendDeviceSettings()
   sendJsonSettingObj("newsapiMaxMsg",     settingNewsMaxMsg,       "i",   1,   20);
   sendJsonSettingObj("newsapiInterval",   settingNewsInterval,     "i",  15,  120);
   sendJsonSettingObj("newsNoWords",       settingNewsNoWords,      "s", sizeof(settingNewsNoWords) -1);
+  sendJsonSettingObj("playClock",         settingPlayWeight[PLAY_CLOCK],   "i", 0, PLAY_WEIGHT_MAX);
+  sendJsonSettingObj("playLocal",         settingPlayWeight[PLAY_LOCAL],   "i", 0, PLAY_WEIGHT_MAX);
+  sendJsonSettingObj("playNews",          settingPlayWeight[PLAY_NEWS],    "i", 0, PLAY_WEIGHT_MAX);
+  sendJsonSettingObj("playWeather",       settingPlayWeight[PLAY_WEATHER], "i", 0, PLAY_WEIGHT_MAX);
+  sendJsonSettingObj("displayModules",    settingDisplayModules,   "i",   1, MAX_DEVICES);
+  sendJsonSettingObj("clockModules",      settingClockModules,     "i",   0, MAX_DEVICES -1);
 
   sendEndJsonObj();
 
@@ -212,17 +301,12 @@ void sendLocalMessages()
   {
     if (readFileById("LCL", mID))
     {
-      //--- next 5 lines are realy dirty ...
-      char   newMsg[LOCAL_SIZE] = "";
-      String tmp = String(fileMessage);
-      tmp.replace("\\", "\\\\");
-      sprintf(newMsg, "%s", tmp.c_str());
-    //sendJsonSettingObj(intToStr(mID), fileMessage, "s", sizeof(fileMessage) -1);
-      sendJsonSettingObj(intToStr(mID), newMsg, "s", sizeof(newMsg) -1);
+      //-- sendJsonMessageObj() takes care of escaping
+      sendJsonMessageObj(intToStr(mID), fileMessage, LOCAL_SIZE -1);
     }
     else
     {
-      sendJsonSettingObj(intToStr(mID), "", "s", sizeof(fileMessage) -1);
+      sendJsonMessageObj(intToStr(mID), "", LOCAL_SIZE -1);
     }
   }
   
@@ -244,7 +328,7 @@ void sendNewsMessages()
   {
     if (readFileById("NWS", nID))
     {
-      sendJsonSettingObj(intToStr(nID), fileMessage, "s", sizeof(fileMessage) -1);
+      sendJsonMessageObj(intToStr(nID), fileMessage, LOCAL_SIZE -1);
     }
   }
   
@@ -253,34 +337,116 @@ void sendNewsMessages()
 } // sendNewsMessages()
 
 
+//-----------------------------------------------------------------------
+//-- PUT body: {"name":"4","value":"Bericht tekst"} or an array of those.
+//-- The body is scanned twice: first every pair is checked, then all are
+//-- applied (only if all are valid) with one flash write, and the status
+//-- of every pair is reported.
+typedef const char *(*bulkCheck)(const char *name, const char *value);
+typedef void        (*bulkApply)(const char *name, const char *value);
+
+typedef struct _bulkState {
+  bool        report;         // second pass
+  bool        hasName;
+  bool        hasValue;
+  bool        tooLong;
+  uint16_t    pairs;          // a body can not hold 64K pairs
+  uint16_t    errors;
+  char        name[JSON_KEY_MAX];
+  char        value[LOCAL_SIZE];
+  bulkCheck   check;
+  bulkApply   apply;
+} bulkState;
+
+static bulkState *bulk = NULL;    // only valid during bulkUpdate()
+
+//-----------------------------------------------------------------------
+static bool onBulkEvent(jsonScanner *js, uint8_t event)
+{
+  const char *error;
+  
+  switch(event)
+  {
+    case JSON_EV_OBJECT_START:
+              bulk->hasName  = false;
+              bulk->hasValue = false;
+              bulk->tooLong  = false;
+              break;
+    case JSON_EV_VALUE:
+              if (!stricmp(js->key, "name"))
+              {
+                strCopy(bulk->name, sizeof(bulk->name), js->val);
+                bulk->hasName = true;
+              }
+              else if (!stricmp(js->key, "value"))
+              {
+                strCopy(bulk->value, sizeof(bulk->value), js->val);
+                bulk->hasValue = true;
+                bulk->tooLong  = js->truncated;
+              }
+              break;
+    case JSON_EV_OBJECT_END:
+              if (!bulk->hasName)   break;
+              if (!bulk->hasValue)  error = "no value";
+              else if (bulk->tooLong) error = "too long";
+              else                  error = bulk->check(bulk->name, bulk->value);
+              if (!bulk->report)
+              {
+                bulk->pairs++;
+                if (error != NULL) bulk->errors++;
+                break;
+              }
+              if (error == NULL && bulk->errors == 0) bulk->apply(bulk->name, bulk->value);
+              sendNestedJsonObj(bulk->name, (error != NULL) ? error : "ok");
+              break;
+  }
+  return true;
+  
+} // onBulkEvent()
+
+
+//-----------------------------------------------------------------------
+static void bulkUpdate(const char *objName, bulkCheck check, bulkApply apply
+                                          , void (*begin)(), void (*commit)())
+{
+  bulkState     state;
+  jsonScanner   js;
+  char          val[LOCAL_SIZE +1];   // one more, so too long is seen
+  const String &body = httpServer.arg("plain");
+
+  memset(&state, 0, sizeof(state));
+  state.check = check;
+  state.apply = apply;
+  bulk        = &state;
+  
+  jsonScanBegin(&js, val, sizeof(val), onBulkEvent);
+  jsonScanFeed(&js, body.c_str(), body.length());
+  DebugTf("%s: [%d] pairs, [%d] errors\r\n", objName, state.pairs, state.errors);
+
+  if (state.pairs == 0)
+  {
+    bulk = NULL;
+    httpServer.send(400, "text/plain", "400: no {\"name\":..,\"value\":..} pairs\r\n");
+    return;
+  }
+  
+  state.report = true;
+  sendStartJsonObj(objName, (state.errors == 0) ? 200 : 400);
+  if (state.errors == 0) begin();
+  jsonScanBegin(&js, val, sizeof(val), onBulkEvent);
+  jsonScanFeed(&js, body.c_str(), body.length());
+  if (state.errors == 0) commit();
+  sendNestedJsonObj("result", (state.errors == 0) ? "committed" : "rejected");
+  sendEndJsonObj();
+  bulk = NULL;
+  
+} // bulkUpdate()
+
+
 //=======================================================================
 void postMessages()
 {
-  //------------------------------------------------------------ 
-  // json string: {"name":"4","value":"Bericht tekst"}  
-  //------------------------------------------------------------ 
-  // so, why not use ArduinoJSON library?
-  // I say: try it yourself ;-) It won't be easy
-      String wOut[5];
-      String wPair[5];
-      String jsonIn  = httpServer.arg(0).c_str();
-      char field[25] = "";
-      char newValue[101]="";
-      jsonIn.replace("{", "");
-      jsonIn.replace("}", "");
-      jsonIn.replace("\"", "");
-      int8_t wp = splitString(jsonIn.c_str(), ',',  wPair, 5) ;
-      for (int i=0; i<wp; i++)
-      {
-        //DebugTf("[%d] -> pair[%s]\r\n", i, wPair[i].c_str());
-        int8_t wc = splitString(wPair[i].c_str(), ':',  wOut, 5) ;
-        //DebugTf("==> [%s] -> field[%s]->val[%s]\r\n", wPair[i].c_str(), wOut[0].c_str(), wOut[1].c_str());
-        if (wOut[0].equalsIgnoreCase("name"))  strCopy(field, sizeof(field), wOut[1].c_str());
-        if (wOut[0].equalsIgnoreCase("value")) strCopy(newValue, sizeof(newValue), wOut[1].c_str());
-      }
-      DebugTf("--> field[%s] => newValue[%s]\r\n", field, newValue);
-      updateMessage(field, newValue);
-      httpServer.send(200, "application/json", httpServer.arg(0));
+  bulkUpdate("messages", checkMessage, updateMessage, beginMessageBatch, commitMessageBatch);
 
 } // postMessages()
 
@@ -288,36 +454,134 @@ void postMessages()
 //=======================================================================
 void postSettings()
 {
-  //------------------------------------------------------------ 
-  // json string: {"name":"settingInterval","value":9}  
-  // json string: {"name":"settingHostname","value":"abc"}  
-  //------------------------------------------------------------ 
-  // so, why not use ArduinoJSON library?
-  // I say: try it yourself ;-) It won't be easy
-      String wOut[5];
-      String wPair[5];
-      String jsonIn  = httpServer.arg(0).c_str();
-      char field[25] = "";
-      char newValue[101]="";
-      jsonIn.replace("{", "");
-      jsonIn.replace("}", "");
-      jsonIn.replace("\"", "");
-      int8_t wp = splitString(jsonIn.c_str(), ',',  wPair, 5) ;
-      for (int i=0; i<wp; i++)
-      {
-        //DebugTf("[%d] -> pair[%s]\r\n", i, wPair[i].c_str());
-        int8_t wc = splitString(wPair[i].c_str(), ':',  wOut, 5) ;
-        //DebugTf("==> [%s] -> field[%s]->val[%s]\r\n", wPair[i].c_str(), wOut[0].c_str(), wOut[1].c_str());
-        if (wOut[0].equalsIgnoreCase("name"))  strCopy(field, sizeof(field), wOut[1].c_str());
-        if (wOut[0].equalsIgnoreCase("value")) strCopy(newValue, sizeof(newValue), wOut[1].c_str());
-      }
-      DebugTf("--> field[%s] => newValue[%s]\r\n", field, newValue);
-      updateSetting(field, newValue);
-      httpServer.send(200, "application/json", httpServer.arg(0));
+  bulkUpdate("settings", checkSetting, updateSetting, beginSettingsBatch, commitSettingsBatch);
 
 } // postSettings()
 
 
+//=======================================================================
+//-- the weights, the order they give and the urgent flag and minutes
+//-- to go of the local messages that have them
+void sendPlaylist()
+{
+  char  order[PLAYLIST_MAX * 8] = "";
+  char  options[20];
+  
+  sendStartJsonObj("playlist");
+  
+  for (uint8_t s=0; s<PLAY_SOURCES; s++)
+  {
+    sendNestedJsonObj(playlistSourceName(s), (int32_t)settingPlayWeight[s]);
+  }
+  for (uint8_t p=0; p<playlistLength(); p++)
+  {
+    if (p > 0) strConcat(order, sizeof(order), ",");
+    strConcat(order, sizeof(order), playlistSourceName(playlistEntry(p)));
+  }
+  sendNestedJsonObj("order", order);
+  
+  for (uint8_t mID=1; mID <= settingLocalMaxMsg; mID++)
+  {
+    uint32_t expires = messageExpires(mID);
+    bool     urgent  = (urgentMessages() & (1UL << mID));
+    if (!urgent && expires == 0) continue;
+    uint32_t minutes = (expires > (uint32_t)now()) ? ((expires - now() + 59) / 60) : 0;
+    snprintf(options, sizeof(options), "%s %u", (urgent ? "urgent" : "normal"), minutes);
+    sendNestedJsonObj(intToStr(mID), options);
+  }
+  
+  sendEndJsonObj();
+
+} // sendPlaylist()
+
+
+//-----------------------------------------------------------------------
+//-- a message value is "urgent" or "normal", optionally followed by the
+//-- minutes before it is removed (0 = never)
+static bool parseMessageOptions(const char *value, bool *urgent, uint32_t *minutes)
+{
+  char *end;
+  
+  if      (!strncmp(value, "urgent", 6))  *urgent = true;
+  else if (!strncmp(value, "normal", 6))  *urgent = false;
+  else                                    return false;
+  value += 6;
+  *minutes = 0;
+  if (*value == '\0') return true;
+  *minutes = strtoul(value, &end, 10);
+  return (end != value && *end == '\0' && *minutes <= (7 * 24 * 60));
+  
+} // parseMessageOptions()
+
+//-----------------------------------------------------------------------
+//-- {"name":"news","value":"5"} sets a weight, {"name":"3","value":"urgent 60"}
+//-- the urgent flag and expiry of LCL-003
+static const char *checkPlaylist(const char *name, const char *value)
+{
+  char     *end;
+  char      key[JSON_KEY_MAX +4];
+  bool      urgent;
+  uint32_t  minutes;
+  
+  if (playlistSource(name) >= 0)
+  {
+    snprintf(key, sizeof(key), "play%s", name);
+    const char *error = checkSetting(key, value);
+    if (error == NULL && atoi(value) > PLAY_WEIGHT_MAX) return "out of range";
+    return error;
+  }
+  long mID = strtol(name, &end, 10);
+  if (end == name || *end != '\0')                   return "unknown source";
+  if (mID < 1 || mID > settingLocalMaxMsg)            return "out of range";
+  if (!(messageSlots("LCL") & (1UL << mID)))          return "no message";
+  if (!parseMessageOptions(value, &urgent, &minutes)) return "not urgent/normal [minutes]";
+  if (minutes > 0 && timeStatus() != timeSet)         return "no time yet";
+  return NULL;
+  
+} // checkPlaylist()
+
+//-----------------------------------------------------------------------
+static void updatePlaylist(const char *name, const char *value)
+{
+  char      key[JSON_KEY_MAX +4];
+  bool      urgent;
+  uint32_t  minutes;
+  
+  if (playlistSource(name) >= 0)
+  {
+    snprintf(key, sizeof(key), "play%s", name);
+    updateSetting(key, value);
+    return;
+  }
+  parseMessageOptions(value, &urgent, &minutes);
+  uint8_t mID = atoi(name);
+  bool    was = (urgentMessages() & (1UL << mID));
+  setMessageOptions(mID, urgent, (minutes > 0) ? (now() + (minutes * 60)) : 0);
+  if (urgent && !was) playlistInterrupt();
+  
+} // updatePlaylist()
+
+static void beginPlaylistBatch()
+{
+  beginSettingsBatch();
+  beginMessageBatch();
+}
+
+static void commitPlaylistBatch()
+{
+  commitMessageBatch();
+  commitSettingsBatch();
+}
+
+
+//=======================================================================
+void postPlaylist()
+{
+  bulkUpdate("playlist", checkPlaylist, updatePlaylist, beginPlaylistBatch, commitPlaylistBatch);
+
+} // postPlaylist()
+
+
 //====================================================
 void sendApiNotFound(const char *URI)
 {
@@ -0,0 +1,155 @@
+#include "schedStuff.h"
+
+/*
+***************************************************************************
+**  Program  : schedStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+//-- The timers of loop() in one table. A task is due when (millis() -
+//-- start) >= wait, which keeps working when millis() wraps after 49 days.
+//-- schedRun() is called when a task starts, schedDone() when a fetch is
+//-- done: a failure waits SCHED_RETRY_MIN, doubled with every next
+//-- failure, up to the period. The waits after a fetch get a bit of
+//-- jitter from a generator seeded with the chip ID, so tickers that are
+//-- powered up together do not all ask weerlive.nl and newsapi.org in the
+//-- same second.
+
+typedef struct _schedTask {
+  uint32_t  start;      // millis() when the wait started
+  uint32_t  wait;       // ms
+  uint32_t  period;     // ms, from the last schedRun()
+  uint8_t   fails;      // failures in a row
+} schedTask;
+
+static schedTask  schedTasks[SCHED_TASKS];
+static uint32_t   jitterState = 1;
+
+
+//=======================================================================
+//-- 0 .. range-1, xorshift32
+static uint32_t jitter(uint32_t range)
+{
+  if (range == 0) return 0;
+  jitterState ^= jitterState << 13;
+  jitterState ^= jitterState >> 17;
+  jitterState ^= jitterState <<  5;
+  return jitterState % range;
+
+} // jitter()
+
+
+//=======================================================================
+//-- all tasks are due at once, the fetches after a bit of jitter (seed:
+//-- the chip ID)
+void schedBegin(uint32_t seed)
+{
+  jitterState = seed | 1;    //-- never 0
+  for (uint8_t t=0; t<SCHED_TASKS; t++)
+  {
+    schedTasks[t].start  = millis();
+    schedTasks[t].wait   = (t < SCHED_FETCHES) ? jitter(SCHED_START_JITTER) : 0;
+    schedTasks[t].period = 0;
+    schedTasks[t].fails  = 0;
+  }
+
+} // schedBegin()
+
+
+//=======================================================================
+bool schedDue(uint8_t task)
+{
+  return (millis() - schedTasks[task].start) >= schedTasks[task].wait;
+
+} // schedDue()
+
+
+//=======================================================================
+//-- the task starts now, it is due again after periodMs
+void schedRun(uint8_t task, uint32_t periodMs)
+{
+  schedTasks[task].start  = millis();
+  schedTasks[task].wait   = periodMs;
+  schedTasks[task].period = periodMs;
+
+} // schedRun()
+
+
+//=======================================================================
+//-- the fetch of task is done, the next one waits a period or backs off
+void schedDone(uint8_t task, bool ok)
+{
+  schedTask *st = &schedTasks[task];
+  uint32_t   wait;
+
+  st->start = millis();
+  if (ok)
+  {
+    st->fails = 0;
+    st->wait  = st->period + jitter(st->period / 16);
+    return;
+  }
+  if (st->fails < 16) st->fails++;
+  wait = (uint32_t)SCHED_RETRY_MIN << (st->fails -1);
+  if (wait > SCHED_RETRY_MAX)                     wait = SCHED_RETRY_MAX;
+  if ((st->period > 0) && (wait > st->period))    wait = st->period;
+  st->wait = wait + jitter(wait / 4);
+  DebugTf("task[%d] failed [%d] times, next in [%u]ms\r\n", task, st->fails, st->wait);
+
+} // schedDone()
+
+
+//=======================================================================
+uint8_t schedFails(uint8_t task)
+{
+  return schedTasks[task].fails;
+
+} // schedFails()
+
+
+//=======================================================================
+//-- ms until the first fetch is due, 0 if one is due now
+uint32_t schedIdleMs()
+{
+  uint32_t idle = SCHED_RETRY_MAX;
+
+  for (uint8_t t=0; t<SCHED_FETCHES; t++)
+  {
+    uint32_t elapsed = millis() - schedTasks[t].start;
+    if (elapsed >= schedTasks[t].wait) return 0;
+    if ((schedTasks[t].wait - elapsed) < idle) idle = schedTasks[t].wait - elapsed;
+  }
+  return idle;
+
+} // schedIdleMs()
+
+
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
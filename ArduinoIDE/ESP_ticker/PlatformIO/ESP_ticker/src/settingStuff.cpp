@@ -10,140 +10,333 @@
 ***************************************************************************      
 */
 
+//-- All settings are described once in settingFields[]. They are kept in
+//-- SETTINGS_BIN (a binary image with a CRC) that is read in one go at
+//-- boot. SETTINGS_FILE (settings.ini) stays the editable/exportable form:
+//-- it is only parsed when there is no valid image (first boot, or after
+//-- settings.ini was uploaded) and rewritten a while after the last change.
+#define SET_STR   0
+#define SET_U8    1
+#define SET_U16   2
+
+typedef struct _settingField {
+  const char  *iniKey;
+  const char  *apiKey;
+  uint8_t      type;
+  void        *ptr;
+  uint16_t     size;      // bytes in the image (SET_STR: the whole buffer)
+} settingField;
+
+static constexpr settingField settingFields[] = {
+  { "Hostname",         "Hostname",         SET_STR, settingHostname,          sizeof(settingHostname) },
+  { "localMaxMsg",      "localMaxMsg",      SET_U8,  &settingLocalMaxMsg,      1 },
+  { "textSpeed",        "textSpeed",        SET_U8,  &settingTextSpeed,        1 },
+  { "maxIntensity",     "maxIntensity",     SET_U8,  &settingMaxIntensity,     1 },
+  { "LDRlowOffset",     "LDRlowOffset",     SET_U16, &settingLDRlowOffset,     2 },
+  { "LDRhighOffset",    "LDRhighOffset",    SET_U16, &settingLDRhighOffset,    2 },
+  { "LDRsampleTime",    "LDRsampleTime",    SET_U16, &settingLDRsampleTime,    2 },
+  { "LDRsmoothing",     "LDRsmoothing",     SET_U8,  &settingLDRsmoothing,     1 },
+  { "weerLiveAUTH",     "weerLiveAUTH",     SET_STR, settingWeerLiveAUTH,      sizeof(settingWeerLiveAUTH) },
+  { "weerLiveLocatie",  "weerLiveLocation", SET_STR, settingWeerLiveLocation,  sizeof(settingWeerLiveLocation) },
+  { "weerLiveInterval", "weerLiveInterval", SET_U8,  &settingWeerLiveInterval, 1 },
+  { "newsAUTH",         "newsapiAUTH",      SET_STR, settingNewsAUTH,          sizeof(settingNewsAUTH) },
+  { "newsNoWords",      "newsNoWords",      SET_STR, settingNewsNoWords,       sizeof(settingNewsNoWords) },
+  { "newsMaxMsg",       "newsapiMaxMsg",    SET_U8,  &settingNewsMaxMsg,       1 },
+  { "newsInterval",     "newsapiInterval",  SET_U8,  &settingNewsInterval,     1 },
+  { "playClock",        "playClock",        SET_U8,  &settingPlayWeight[PLAY_CLOCK],   1 },
+  { "playLocal",        "playLocal",        SET_U8,  &settingPlayWeight[PLAY_LOCAL],   1 },
+  { "playNews",         "playNews",         SET_U8,  &settingPlayWeight[PLAY_NEWS],    1 },
+  { "playWeather",      "playWeather",      SET_U8,  &settingPlayWeight[PLAY_WEATHER], 1 },
+  { "displayModules",   "displayModules",   SET_U8,  &settingDisplayModules,   1 },
+  { "clockModules",     "clockModules",     SET_U8,  &settingClockModules,     1 },
+};
+#define SETTING_FIELDS  (sizeof(settingFields) / sizeof(settingFields[0]))
+
+//-- bytes of all settingFields[] together, settingsToImage() copies them all
+constexpr uint16_t settingsImageBytes(uint8_t f = 0)
+{
+  return (f >= SETTING_FIELDS) ? 0 : settingFields[f].size + settingsImageBytes(f +1);
+}
+static_assert(settingsImageBytes() <= SETTINGS_IMAGE_MAX, "settingFields[] do not fit in SETTINGS_IMAGE_MAX");
+
+typedef struct _settingsHeader {
+  uint32_t  magic;
+  uint32_t  layout;       // CRC32 over the keys and sizes in settingFields[]
+  uint16_t  size;
+  uint16_t  spare;
+  uint32_t  crc;          // CRC32 of the image
+} settingsHeader;
+
+#define SETTINGS_MAGIC      0x54455354    // "TSET"
+#define SETTINGS_INI_DELAY  10000         // ms after the last change
+
+static uint8_t  settingsImage[SETTINGS_IMAGE_MAX];
+static uint16_t settingsImageSize = 0;
+static uint16_t iniKeyHash[SETTING_FIELDS];
+static uint16_t apiKeyHash[SETTING_FIELDS];
+static uint32_t settingsLayout    = 0;
+static uint32_t iniWriteTimer     = 0;
+static bool     iniDirty          = false;
+static uint8_t  settingsBatchDepth = 0;
+static bool     settingsBatchDirty = false;
+static uint32_t settingsPushBits   = 0;     // changed since the last push (bit = field)
+
 //=======================================================================
-void writeSettings(bool show) 
+//-- case insensitive key hash, so most lookups do only one stricmp()
+static uint16_t keyHash(const char *key)
 {
-  DebugTf("Writing to [%s] ..\r\n", SETTINGS_FILE);
-  File file = LittleFS.open(SETTINGS_FILE, "w"); // open for reading and writing
-  if (!file) 
+  uint32_t h = 2166136261u;     // FNV-1a
+  
+  for (; *key; key++)
   {
-    DebugTf("open(%s, 'w') FAILED!!! --> Bailout\r\n", SETTINGS_FILE);
-    return;
+    char c = *key;
+    if (c >= 'A' && c <= 'Z') c += 32;
+    h = (h ^ (uint8_t)c) * 16777619u;
   }
-  yield();
+  return (h ^ (h >> 16));
+  
+} // keyHash()
 
-  DebugT(F("Start writing setting data "));
 
-  file.print("Hostname = ");          file.println(settingHostname);            Debug(F("."));
-  file.print("localMaxMsg = ");       file.println(settingLocalMaxMsg);         Debug(F("."));
-  file.print("textSpeed = ");         file.println(settingTextSpeed);           Debug(F("."));
-  file.print("maxIntensity = ");      file.println(settingMaxIntensity);        Debug(F("."));
-  file.print("LDRlowOffset = ");      file.println(settingLDRlowOffset);        Debug(F("."));
-  file.print("LDRhighOffset = ");     file.println(settingLDRhighOffset);       Debug(F("."));
-  file.print("weerLiveAUTH = ");      file.println(settingWeerLiveAUTH);        Debug(F("."));
-  file.print("weerLiveLocatie = ");   file.println(settingWeerLiveLocation);    Debug(F("."));
-  file.print("weerLiveInterval = ");  file.println(settingWeerLiveInterval);    Debug(F("."));
-  file.print("newsAUTH = ");          file.println(settingNewsAUTH);            Debug(F("."));
-  file.print("newsNoWords = ");       file.println(settingNewsNoWords);         Debug(F("."));
-  file.print("newsMaxMsg = ");        file.println(settingNewsMaxMsg);          Debug(F("."));
-  file.print("newsInterval = ");      file.println(settingNewsInterval);        Debug(F("."));
+//=======================================================================
+static void buildKeyHashes()
+{
+  if (settingsLayout != 0) return;
+  
+  for (uint8_t f=0; f<SETTING_FIELDS; f++)
+  {
+    iniKeyHash[f]  = keyHash(settingFields[f].iniKey);
+    apiKeyHash[f]  = keyHash(settingFields[f].apiKey);
+    settingsLayout = calcCRC32(settingFields[f].iniKey, strlen(settingFields[f].iniKey), settingsLayout);
+    settingsLayout = calcCRC32(&settingFields[f].size, sizeof(settingFields[f].size), settingsLayout);
+  }
+  
+} // buildKeyHashes()
 
-  file.close();  
+
+//=======================================================================
+//-- index in settingFields[], -1 if there is no such key
+static int8_t findSetting(const char *key, bool isApiKey)
+{
+  uint16_t  h = keyHash(key);
   
-  Debugln(F(" done"));
+  buildKeyHashes();
+  for (uint8_t f=0; f<SETTING_FIELDS; f++)
+  {
+    if ((isApiKey ? apiKeyHash[f] : iniKeyHash[f]) != h) continue;
+    if (!stricmp(key, (isApiKey ? settingFields[f].apiKey : settingFields[f].iniKey))) return f;
+  }
+  return -1;
+  
+} // findSetting()
 
-  if (show) 
+
+//=======================================================================
+static void setSettingValue(uint8_t f, const char *value)
+{
+  const settingField *sf = &settingFields[f];
+  
+  switch(sf->type)
   {
-    DebugTln(F("Wrote this:"));
-    DebugT(F("        Hostname = ")); Debugln(settingHostname);
-    DebugT(F("     newsNoWords = ")); Debugln(settingNewsNoWords);
-    DebugT(F("     localMaxMsg = ")); Debugln(settingLocalMaxMsg);     
-    DebugT(F("       textSpeed = ")); Debugln(settingTextSpeed);     
-    DebugT(F("    LDRlowOffset = ")); Debugln(settingLDRlowOffset);     
-    DebugT(F("   LDRhighOffset = ")); Debugln(settingLDRhighOffset);     
-    DebugT(F("    maxIntensity = ")); Debugln(settingMaxIntensity);     
-    DebugT(F("    weerLiveAUTH = ")); Debugln(settingWeerLiveAUTH);     
-    DebugT(F(" weerLiveLocatie = ")); Debugln(settingWeerLiveLocation);     
-    DebugT(F("weerLiveInterval = ")); Debugln(settingWeerLiveInterval);     
-    DebugT(F("        newsAUTH = ")); Debugln(settingNewsAUTH);     
-    DebugT(F("      newsMaxMsg = ")); Debugln(settingNewsMaxMsg);    
-    DebugT(F("    newsInterval = ")); Debugln(settingNewsInterval);    
+    case SET_STR:   snprintf((char*)sf->ptr, sf->size, "%s", value);
+                    break;
+    case SET_U8:    *(uint8_t*)sf->ptr  = atoi(value);
+                    break;
+    case SET_U16:   *(uint16_t*)sf->ptr = atoi(value);
+                    break;
+  }
+  
+} // setSettingValue()
 
-  } // Verbose
+
+//=======================================================================
+//-- copy all settings into (or out of) settingsImage[]
+static uint16_t settingsToImage(uint8_t *image)
+{
+  uint16_t pos = 0;
   
-} // writeSettings()
+  for (uint8_t f=0; f<SETTING_FIELDS; f++)
+  {
+    memcpy(&image[pos], settingFields[f].ptr, settingFields[f].size);
+    pos += settingFields[f].size;
+  }
+  return pos;
+  
+} // settingsToImage()
+
+static void imageToSettings(const uint8_t *image)
+{
+  uint16_t pos = 0;
+  
+  for (uint8_t f=0; f<SETTING_FIELDS; f++)
+  {
+    memcpy(settingFields[f].ptr, &image[pos], settingFields[f].size);
+    if (settingFields[f].type == SET_STR) ((char*)settingFields[f].ptr)[settingFields[f].size -1] = '\0';
+    pos += settingFields[f].size;
+  }
+  
+} // imageToSettings()
 
 
 //=======================================================================
-void readSettings(bool show) 
+static void fillSettingsHeader(settingsHeader *hdr)
 {
-  String sTmp;
-  String words[10];
-  char cTmp[LOCAL_SIZE], cVal[101], cKey[101];
+  hdr->magic  = SETTINGS_MAGIC;
+  hdr->layout = settingsLayout;
+  hdr->size   = settingsImageSize;
+  hdr->spare  = 0;
+  hdr->crc    = calcCRC32(settingsImage, settingsImageSize);
   
-  File file;
+} // fillSettingsHeader()
+
+
+//=======================================================================
+//-- write the (changed part of the) image to SETTINGS_BIN
+static void writeSettingsImage()
+{
+  static uint8_t  newImage[SETTINGS_IMAGE_MAX];
+  settingsHeader  hdr;
+  uint16_t        first, last;
+  bool            whole = (settingsImageSize == 0) || !LittleFS.exists(SETTINGS_BIN);
   
-  DebugTf(" %s ..\r\n", SETTINGS_FILE);
+  buildKeyHashes();
+  uint16_t size = settingsToImage(newImage);
+  if (!whole && size != settingsImageSize) whole = true;
+  
+  for (first=0; first<size && newImage[first] == settingsImage[first]; first++) ;
+  if (!whole && first == size) return;    // nothing changed
+  for (last=size; last>first && newImage[last-1] == settingsImage[last-1]; last--) ;
+  
+  memcpy(settingsImage, newImage, size);
+  settingsImageSize = size;
+  fillSettingsHeader(&hdr);
+  
+  uint32_t start = micros();
+  File file = LittleFS.open(SETTINGS_BIN, (whole ? "w" : "r+"));
+  if (!file) 
+  {
+    ErrorTf("open(%s) FAILED!!! --> Bailout\r\n", SETTINGS_BIN);
+    return;
+  }
+  file.write((const uint8_t*)&hdr, sizeof(hdr));
+  if (whole)
+  {
+    file.write(settingsImage, settingsImageSize);
+  }
+  else
+  {
+    file.seek(sizeof(hdr) + first, SeekSet);
+    file.write(&settingsImage[first], last - first);
+  }
+  file.close();
+  metricsFsOp(true, start);
+  DebugTf("[%s] %s, [%d] bytes\r\n", SETTINGS_BIN, (whole ? "written" : "updated")
+                                    , (whole ? settingsImageSize : (last - first)));
+  
+} // writeSettingsImage()
 
-  snprintf(settingHostname,    sizeof(settingHostname), "%s", _HOSTNAME);
-  snprintf(settingNewsNoWords, sizeof(settingNewsNoWords),"Voetbal, show, UEFA, KNVB");
-  settingLocalMaxMsg        =   5;
-  settingTextSpeed          =  25;
-  settingLDRlowOffset       =  70;
-  settingLDRhighOffset      = 700;
-  settingMaxIntensity       =   6;
-  snprintf(settingWeerLiveAUTH,     50, "");
-  snprintf(settingWeerLiveLocation, 50, "");
-  settingWeerLiveInterval   =   0;
-  snprintf(settingNewsAUTH,         50, "");
-  settingNewsMaxMsg         =   4;
-  settingNewsInterval       =   0;
 
-  if (!LittleFS.exists(SETTINGS_FILE)) 
+//=======================================================================
+static bool readSettingsImage()
+{
+  settingsHeader  hdr;
+  bool            ok = false;
+  
+  buildKeyHashes();
+  uint32_t start = micros();
+  File file = LittleFS.open(SETTINGS_BIN, "r");
+  if (!file) return false;
+  
+  if (file.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr)
+        && hdr.magic  == SETTINGS_MAGIC
+        && hdr.layout == settingsLayout
+        && hdr.size   <= SETTINGS_IMAGE_MAX
+        && file.read(settingsImage, hdr.size) == hdr.size
+        && calcCRC32(settingsImage, hdr.size) == hdr.crc)
   {
-    DebugTln(F(" .. file not found! --> created file!"));
-    writeSettings(show);
+    imageToSettings(settingsImage);
+    settingsImageSize = hdr.size;
+    ok = true;
   }
+  file.close();
+  metricsFsOp(false, start);
+  if (!ok) DebugTf("[%s] is not valid, use [%s]\r\n", SETTINGS_BIN, SETTINGS_FILE);
+  return ok;
+  
+} // readSettingsImage()
 
-  for (int T = 0; T < 2; T++) 
+
+//=======================================================================
+static void readSettingsIni()
+{
+  char cTmp[LOCAL_SIZE], cKey[101];
+  
+  uint32_t start = micros();
+  File file = LittleFS.open(SETTINGS_FILE, "r");
+  if (!file) 
   {
-    file = LittleFS.open(SETTINGS_FILE, "r");
-    if (!file) 
-    {
-      if (T == 0) DebugTf(" .. something went wrong opening [%s]\r\n", SETTINGS_FILE);
-      else        DebugT(T);
-      delay(100);
-    }
-  } // try T times ..
+    ErrorTf(" .. something went wrong opening [%s]\r\n", SETTINGS_FILE);
+    return;
+  }
 
   DebugTln(F("Reading settings:\r"));
   while(file.available()) 
   {
-    sTmp = file.readStringUntil('\n');
-    snprintf(cTmp, sizeof(cTmp), "%s", sTmp.c_str());
-    //strTrim(cTmp, sizeof(cTmp), '\r');
+    int l = file.readBytesUntil('\n', cTmp, sizeof(cTmp) -1);
+    cTmp[l] = '\0';
     strTrimCntr(cTmp, sizeof(cTmp));
-    //DebugTf("cTmp[%s] (%d)\r\n", cTmp, strlen(cTmp));
     int sEq = strIndex(cTmp, "=");
+    if (sEq < 1) continue;
     strCopy(cKey, 100, cTmp, 0, sEq -1);
-    strCopy(cVal, 100, cTmp, sEq +1, strlen(cTmp));
-    //DebugTf("cKey[%s], cVal[%s]\r\n", cKey, cVal);
     strTrim(cKey, sizeof(cKey), ' ');
-    strTrim(cVal, sizeof(cVal), ' ');
+    char *cVal = &cTmp[sEq +1];
+    while (*cVal == ' ') cVal++;
+    strTrim(cVal, sizeof(cTmp) - (cVal - cTmp), ' ');
     //DebugTf("cKey[%s], cVal[%s]\r\n", cKey, cVal);
 
-    //strToLower(cKey);
-    if (stricmp(cKey, "hostname") == 0)         strCopy(settingHostname,         sizeof(settingHostname), cVal);
-    if (stricmp(cKey, "localMaxMsg") == 0)      settingLocalMaxMsg      = atoi(cVal);
-    if (stricmp(cKey, "textSpeed") == 0)        settingTextSpeed        = atoi(cVal);
-    if (stricmp(cKey, "LDRlowOffset") == 0)     settingLDRlowOffset     = atoi(cVal);
-    if (stricmp(cKey, "LDRhighOffset") == 0)    settingLDRhighOffset    = atoi(cVal);
-    if (stricmp(cKey, "maxIntensity") == 0)     settingMaxIntensity     = atoi(cVal);
-    if (stricmp(cKey, "weerLiveAUTH") == 0)     strCopy(settingWeerLiveAUTH,     sizeof(settingWeerLiveAUTH), cVal);
-    if (stricmp(cKey, "weerlivelocatie") == 0)  strCopy(settingWeerLiveLocation, sizeof(settingWeerLiveLocation), cVal);
-    if (stricmp(cKey, "weerLiveInterval") == 0) settingWeerLiveInterval = atoi(cVal);
-    if (stricmp(cKey, "newsAUTH") == 0)         strCopy(settingNewsAUTH,         sizeof(settingNewsAUTH), cVal);
-    if (stricmp(cKey, "newsNoWords") == 0)      strCopy(settingNewsNoWords,      sizeof(settingNewsNoWords), cVal);
-    if (stricmp(cKey, "newsMaxMsg") == 0)       settingNewsMaxMsg       = atoi(cVal);
-    if (stricmp(cKey, "newsInterval") == 0)     settingNewsInterval     = atoi(cVal);
+    int8_t f = findSetting(cKey, false);
+    if (f >= 0) setSettingValue(f, cVal);
 
   } // while available()
   
   file.close();  
+  metricsFsOp(false, start);
+  
+} // readSettingsIni()
 
-  //--- this will take some time to settle in
-  //--- probably need a reboot before that to happen :-(
-  MDNS.setHostname(settingHostname);    // start advertising with new(?) settingHostname
+
+//=======================================================================
+static void defaultSettings()
+{
+  snprintf(settingHostname,    sizeof(settingHostname), "%s", _HOSTNAME);
+  snprintf(settingNewsNoWords, sizeof(settingNewsNoWords),"Voetbal, show, UEFA, KNVB");
+  settingLocalMaxMsg        =   5;
+  settingTextSpeed          =  25;
+  settingLDRlowOffset       =  70;
+  settingLDRhighOffset      = 700;
+  settingLDRsampleTime      = 250;
+  settingLDRsmoothing       =   8;
+  settingMaxIntensity       =   6;
+  snprintf(settingWeerLiveAUTH,     50, "");
+  snprintf(settingWeerLiveLocation, 50, "");
+  settingWeerLiveInterval   =   0;
+  snprintf(settingNewsAUTH,         50, "");
+  settingNewsMaxMsg         =   4;
+  settingNewsInterval       =   0;
+  //-- the order the fixed playlist used to have
+  settingPlayWeight[PLAY_CLOCK]   = 1;
+  settingPlayWeight[PLAY_LOCAL]   = 2;
+  settingPlayWeight[PLAY_NEWS]    = 5;
+  settingPlayWeight[PLAY_WEATHER] = 1;
+  settingDisplayModules     = MAX_DEVICES;
+  settingClockModules       =   0;    // no clock zone
+  
+} // defaultSettings()
+
+
+//=======================================================================
+static void checkSettings()
+{
   if (settingLocalMaxMsg > 20)        settingLocalMaxMsg      =   20;
   if (settingLocalMaxMsg <  1)        settingLocalMaxMsg      =    1;
   if (settingTextSpeed > MAX_SPEED)   settingTextSpeed        =  MAX_SPEED;
@@ -152,6 +345,10 @@ void readSettings(bool show)
   if (settingLDRlowOffset  <    1)    settingLDRlowOffset     =    0;
   if (settingLDRhighOffset <  500)    settingLDRhighOffset    =  500;
   if (settingLDRhighOffset > 1024)    settingLDRhighOffset    = 1024;
+  if (settingLDRsampleTime <   50)    settingLDRsampleTime    =   50;
+  if (settingLDRsampleTime > 5000)    settingLDRsampleTime    = 5000;
+  if (settingLDRsmoothing  <    1)    settingLDRsmoothing     =    1;
+  if (settingLDRsmoothing  >   50)    settingLDRsmoothing     =   50;
   if (settingMaxIntensity > 15)       settingMaxIntensity     =   15;
   if (settingMaxIntensity <  1)       settingMaxIntensity     =    1;
   if (strlen(settingWeerLiveLocation) <  1)  sprintf(settingWeerLiveLocation, "Amsterdam");
@@ -175,6 +372,107 @@ void readSettings(bool show)
   {
     if (settingNewsInterval <  15)    settingNewsInterval     =   15;
   }
+  for (uint8_t s=0; s<PLAY_SOURCES; s++)
+  {
+    if (settingPlayWeight[s] > PLAY_WEIGHT_MAX) settingPlayWeight[s] = PLAY_WEIGHT_MAX;
+  }
+  if (settingDisplayModules > MAX_DEVICES)  settingDisplayModules = MAX_DEVICES;
+  if (settingDisplayModules <  1)           settingDisplayModules =   1;
+  //-- the scrolling zone keeps at least one module
+  if (settingClockModules >= settingDisplayModules) settingClockModules = settingDisplayModules -1;
+  
+} // checkSettings()
+
+
+//=======================================================================
+//-- (re)write settings.ini from the current settings
+void writeSettings(bool show) 
+{
+  DebugTf("Writing to [%s] ..\r\n", SETTINGS_FILE);
+  uint32_t start = micros();
+  File file = LittleFS.open(SETTINGS_FILE, "w"); // open for reading and writing
+  if (!file) 
+  {
+    ErrorTf("open(%s, 'w') FAILED!!! --> Bailout\r\n", SETTINGS_FILE);
+    return;
+  }
+  yield();
+
+  DebugT(F("Start writing setting data "));
+
+  for (uint8_t f=0; f<SETTING_FIELDS; f++)
+  {
+    const settingField *sf = &settingFields[f];
+    file.print(sf->iniKey);
+    file.print(" = ");
+    switch(sf->type)
+    {
+      case SET_STR:   file.println((const char*)sf->ptr);     break;
+      case SET_U8:    file.println(*(uint8_t*)sf->ptr);       break;
+      case SET_U16:   file.println(*(uint16_t*)sf->ptr);      break;
+    }
+    Debug(F("."));
+  }
+
+  file.close();  
+  metricsFsOp(true, start);
+  iniDirty = false;
+  
+  Debugln(F(" done"));
+
+  if (show) 
+  {
+    DebugTln(F("Wrote this:"));
+    DebugT(F("        Hostname = ")); Debugln(settingHostname);
+    DebugT(F("     newsNoWords = ")); Debugln(settingNewsNoWords);
+    DebugT(F("     localMaxMsg = ")); Debugln(settingLocalMaxMsg);     
+    DebugT(F("       textSpeed = ")); Debugln(settingTextSpeed);     
+    DebugT(F("    LDRlowOffset = ")); Debugln(settingLDRlowOffset);     
+    DebugT(F("   LDRhighOffset = ")); Debugln(settingLDRhighOffset);     
+    DebugT(F("   LDRsampleTime = ")); Debugln(settingLDRsampleTime);     
+    DebugT(F("    LDRsmoothing = ")); Debugln(settingLDRsmoothing);     
+    DebugT(F("    maxIntensity = ")); Debugln(settingMaxIntensity);     
+    DebugT(F("    weerLiveAUTH = ")); Debugln(settingWeerLiveAUTH);     
+    DebugT(F(" weerLiveLocatie = ")); Debugln(settingWeerLiveLocation);     
+    DebugT(F("weerLiveInterval = ")); Debugln(settingWeerLiveInterval);     
+    DebugT(F("        newsAUTH = ")); Debugln(settingNewsAUTH);     
+    DebugT(F("      newsMaxMsg = ")); Debugln(settingNewsMaxMsg);    
+    DebugT(F("    newsInterval = ")); Debugln(settingNewsInterval);    
+    DebugT(F("       playClock = ")); Debugln(settingPlayWeight[PLAY_CLOCK]);
+    DebugT(F("       playLocal = ")); Debugln(settingPlayWeight[PLAY_LOCAL]);
+    DebugT(F("        playNews = ")); Debugln(settingPlayWeight[PLAY_NEWS]);
+    DebugT(F("     playWeather = ")); Debugln(settingPlayWeight[PLAY_WEATHER]);
+    DebugT(F("  displayModules = ")); Debugln(settingDisplayModules);
+    DebugT(F("    clockModules = ")); Debugln(settingClockModules);
+
+  } // Verbose
+  
+} // writeSettings()
+
+
+//=======================================================================
+void readSettings(bool show) 
+{
+  DebugTf(" %s ..\r\n", SETTINGS_BIN);
+
+  defaultSettings();
+
+  if (!readSettingsImage())
+  {
+    if (!LittleFS.exists(SETTINGS_FILE)) 
+    {
+      DebugTln(F(" .. file not found! --> created file!"));
+      writeSettings(show);
+    }
+    else readSettingsIni();
+    checkSettings();
+    writeSettingsImage();
+  }
+  else checkSettings();
+
+  //--- this will take some time to settle in
+  //--- probably need a reboot before that to happen :-(
+  platformMdnsHostname(settingHostname);  // start advertising with new(?) settingHostname
 
   DebugTln(F(" .. done\r"));
 
@@ -186,6 +484,8 @@ void readSettings(bool show)
   Debugf("               text Speed : %d\r\n",  settingTextSpeed);
   Debugf("           LDR low offset : %d\r\n",  settingLDRlowOffset);
   Debugf("          LDR high offset : %d\r\n",  settingLDRhighOffset);
+  Debugf("          LDR sample time : %d\r\n",  settingLDRsampleTime);
+  Debugf("            LDR smoothing : %d\r\n",  settingLDRsmoothing);
   Debugf("            max Intensity : %d\r\n",  settingMaxIntensity);
   Debugf("         WeerLive.nl AUTH : %s\r\n",  settingWeerLiveAUTH);
   Debugf("      WeerLive.nl Locatie : %s\r\n",  settingWeerLiveLocation);
@@ -194,19 +494,125 @@ void readSettings(bool show)
   Debugf("      newsapi.org NoWords : %s\r\n",  settingNewsNoWords);
   Debugf("     newsapi.org Max. Msg : %d\r\n",  settingNewsMaxMsg);
   Debugf("     newsapi.org Interval : %d\r\n",  settingNewsInterval);
+  Debugf("  playlist clock/local/news/weather : %d/%d/%d/%d\r\n"
+                                      , settingPlayWeight[PLAY_CLOCK], settingPlayWeight[PLAY_LOCAL]
+                                      , settingPlayWeight[PLAY_NEWS],  settingPlayWeight[PLAY_WEATHER]);
+  Debugf("   display / clock modules : %d / %d\r\n", settingDisplayModules, settingClockModules);
   
   Debugln(F("-\r"));
 
 } // readSettings()
 
 
+//=======================================================================
+//-- settings.ini is about to be read (exported), bring it up-to-date
+void settingsExport()
+{
+  if (iniDirty) writeSettings(false);
+  
+} // settingsExport()
+
+
+//=======================================================================
+//-- a new settings.ini was uploaded, it wins at the next boot
+void settingsIniChanged()
+{
+  iniDirty = false;
+  LittleFS.remove(SETTINGS_BIN);
+  settingsImageSize = 0;
+  
+} // settingsIniChanged()
+
+
+//=======================================================================
+//-- write settings.ini when there were no changes for a while
+void settingsLoop()
+{
+  if (iniDirty && (millis() - iniWriteTimer) > SETTINGS_INI_DELAY)
+  {
+    writeSettings(false);
+  }
+  
+} // settingsLoop()
+
+
+//=======================================================================
+//-- after a change: clamp, save the image and rebuild what depends on it
+static void settingsChanged()
+{
+  checkSettings();
+
+  writeSettingsImage();
+  iniDirty      = true;
+  iniWriteTimer = millis();
+
+  if (settingWeerLiveInterval == 0)      memset(tempMessage, 0, sizeof(tempMessage));
+  if (settingNewsInterval == 0)          removeNewsData();
+  //--- rebuild noWords matcher --
+  splitNewsNoWords(settingNewsNoWords);
+  playlistBuild();
+  
+} // settingsChanged()
+
+
+//=======================================================================
+//-- NULL if newValue can be stored in field, else the reason why not
+const char *checkSetting(const char *field, const char *newValue)
+{
+  char *end;
+  
+  int8_t f = findSetting(field, true);
+  if (f < 0)                        return "unknown setting";
+
+  const settingField *sf = &settingFields[f];
+  if (sf->type == SET_STR)
+  {
+    return (strlen(newValue) < sf->size) ? NULL : "too long";
+  }
+  long v = strtol(newValue, &end, 10);
+  if (end == newValue || *end != '\0') return "not a number";
+  if (v < 0 || v > ((sf->type == SET_U8) ? 0xFF : 0xFFFF))  return "out of range";
+  return NULL;
+  
+} // checkSetting()
+
+
+//=======================================================================
+//-- updateSetting()'s between these are saved with one image write
+void beginSettingsBatch()
+{
+  settingsBatchDepth++;
+  
+} // beginSettingsBatch()
+
+
+//=======================================================================
+void commitSettingsBatch()
+{
+  if (settingsBatchDepth == 0 || --settingsBatchDepth > 0) return;
+  if (!settingsBatchDirty)  return;
+  
+  settingsBatchDirty = false;
+  settingsChanged();
+  
+} // commitSettingsBatch()
+
+
 //=======================================================================
 void updateSetting(const char *field, const char *newValue)
 {
   DebugTf("-> field[%s], newValue[%s]\r\n", field, newValue);
 
+  int8_t f = findSetting(field, true);
+  if (f < 0)
+  {
+    DebugTf("unknown setting [%s]\r\n", field);
+    return;
+  }
+  setSettingValue(f, newValue);
+  settingsPushBits |= (1UL << f);
+  
   if (!stricmp(field, "Hostname")) {
-    strCopy(settingHostname, sizeof(settingHostname), newValue); 
     if (strlen(settingHostname) < 1) strCopy(settingHostname, sizeof(settingHostname), _HOSTNAME); 
     char *dotPntr = strchr(settingHostname, '.') ;
     if (dotPntr != NULL)
@@ -217,31 +623,43 @@ void updateSetting(const char *field, const char *newValue)
     Debugln();
     DebugTf("Need reboot before new %s.local will be available!\r\n\n", settingHostname);
   }
-  if (!stricmp(field, "localMaxMsg"))      settingLocalMaxMsg   = String(newValue).toInt();  
-  if (!stricmp(field, "textSpeed"))        settingTextSpeed     = String(newValue).toInt();  
-  if (!stricmp(field, "LDRlowOffset"))     settingLDRlowOffset  = String(newValue).toInt();  
-  if (!stricmp(field, "LDRhighOffset"))    settingLDRhighOffset = String(newValue).toInt();  
-  if (!stricmp(field, "maxIntensity"))     settingMaxIntensity  = String(newValue).toInt();  
+  //-- MD_Parola sets up its zones only once, in setup()
+  if (!stricmp(field, "displayModules") || !stricmp(field, "clockModules"))
+  {
+    DebugTf("Need reboot before the new display layout is used!\r\n");
+  }
 
-  if (!stricmp(field, "weerLiveAUTH"))     strCopy(settingWeerLiveAUTH, sizeof(settingWeerLiveAUTH), newValue);   
-  if (!stricmp(field, "weerLiveLocation")) strCopy(settingWeerLiveLocation, sizeof(settingWeerLiveLocation), newValue);
-  if (!stricmp(field, "weerLiveInterval")) settingWeerLiveInterval  = String(newValue).toInt();  
+  if (settingsBatchDepth > 0)
+  {
+    settingsBatchDirty = true;
+    return;
+  }
+  settingsChanged();
   
-  if (!stricmp(field, "newsapiAUTH"))      strCopy(settingNewsAUTH, sizeof(settingNewsAUTH), newValue);   
-  if (!stricmp(field, "newsNoWords"))      strCopy(settingNewsNoWords, sizeof(settingNewsNoWords), newValue);   
-  if (!stricmp(field, "newsapiMaxMsg"))    settingNewsMaxMsg   = String(newValue).toInt();
-  if (!stricmp(field, "newsapiInterval"))  settingNewsInterval = String(newValue).toInt();
+} // updateSetting()
 
-  writeSettings(false);
 
-  if (settingWeerLiveInterval == 0)      memset(tempMessage, 0, sizeof(tempMessage));
-  else if (settingWeerLiveInterval < 15) settingWeerLiveInterval = 15;
-  if (settingNewsInterval == 0)          removeNewsData();
-  else if (settingNewsInterval < 15)     settingNewsInterval = 15;
-  //--- rebuild noWords array --
-  splitNewsNoWords(settingNewsNoWords);
+//=======================================================================
+//-- the next setting changed by updateSetting() for the push channel,
+//-- false if there are no more
+bool nextChangedSetting(const char **name, char *value, int maxLen)
+{
+  if (settingsPushBits == 0) return false;
   
-} // updateSetting()
+  uint8_t f = __builtin_ctz(settingsPushBits);
+  settingsPushBits &= ~(1UL << f);
+
+  const settingField *sf = &settingFields[f];
+  *name = sf->apiKey;
+  switch(sf->type)
+  {
+    case SET_STR:   strCopy(value, maxLen, (const char*)sf->ptr);           break;
+    case SET_U8:    snprintf(value, maxLen, "%u", *(uint8_t*)sf->ptr);      break;
+    case SET_U16:   snprintf(value, maxLen, "%u", *(uint16_t*)sf->ptr);     break;
+  }
+  return true;
+  
+} // nextChangedSetting()
 
 
 /***************************************************************************
@@ -0,0 +1,281 @@
+#include "sysLogStuff.h"
+
+/*
+***************************************************************************
+**  Program  : sysLogStuff, part of ESP_ticker
+**
+**  Copyright (c) 2023 Willem Aandewiel
+**
+**  TERMS OF USE: MIT License. See bottom of file.
+***************************************************************************
+*/
+
+#include "platformStuff.h"
+
+extern ESP8266WebServer httpServer;
+
+//-- The persistent system log. writeToLog() only adds the line to a RAM
+//-- stage, that goes to flash in one write when it is SYSLOG_FLUSH_SIZE
+//-- full, SYSLOG_FLUSH_MS old or when sysLogFlush() is called before a
+//-- reboot. The log is kept in segments SYSLOG_DIR/nnnnn.csv of about
+//-- SYSLOG_SEGMENT_SIZE bytes, only the last SYSLOG_SEGMENTS are kept.
+//-- Every restart goes through rebootDevice() (or sysLogBeforeReboot()
+//-- when a library restarts), so no staged line is lost.
+
+static char     logStage[SYSLOG_STAGE_SIZE];
+static uint16_t logStageLen   = 0;
+static uint32_t logStageSince = 0;      // millis() of the oldest staged line
+static uint32_t segFirst      = 0;      // oldest segment
+static uint32_t segLast       = 0;      // segment being written
+static uint32_t segSize       = 0;      // bytes in segLast
+static uint32_t sysLogLostCnt = 0;
+static bool     sysLogReady   = false;
+
+
+//=======================================================================
+static void segmentName(char *dest, int maxLen, uint32_t seq)
+{
+  snprintf(dest, maxLen, SYSLOG_DIR "/%05u.csv", seq);
+
+} // segmentName()
+
+
+//=======================================================================
+//-- the last SYSLOG_SEGMENT_SIZE bytes of SYSLOG_LEGACY become segment 0
+static void adoptLegacyLog()
+{
+  char      fName[30];
+  char      buff[NET_CHUNK_SIZE];
+  File      oldLog = LittleFS.open(SYSLOG_LEGACY, "r");
+  uint32_t  copied = 0;
+
+  if (!oldLog) return;
+  if (oldLog.size() > SYSLOG_SEGMENT_SIZE)
+  {
+    //-- from the first whole line
+    oldLog.seek(oldLog.size() - SYSLOG_SEGMENT_SIZE, SeekSet);
+    while (oldLog.available() && oldLog.read() != '\n') ;
+  }
+  segmentName(fName, sizeof(fName), 0);
+  File seg = LittleFS.open(fName, "w");
+  while (seg && oldLog.available())
+  {
+    int len = oldLog.read((uint8_t*)buff, sizeof(buff));
+    if (len <= 0) break;
+    seg.write((const uint8_t*)buff, len);
+    copied += len;
+  }
+  if (seg) seg.close();
+  oldLog.close();
+  segFirst = segLast = 0;
+  segSize  = copied;
+  InfoTf("[%s] moved to [%s], [%u] bytes kept\r\n", SYSLOG_LEGACY, fName, copied);
+
+} // adoptLegacyLog()
+
+
+//=======================================================================
+//-- find the oldest and the newest segment, once at boot
+void sysLogBegin()
+{
+  bool  found = false;
+  fsDir dir(SYSLOG_DIR);
+
+  while (dir.next())
+  {
+    uint32_t seq = atol(dir.fileName().c_str());
+    if (!found || seq < segFirst) segFirst = seq;
+    if (!found || seq > segLast)
+    {
+      segLast = seq;
+      segSize = dir.fileSize();
+    }
+    found = true;
+  }
+  if (!found) LittleFS.mkdir(SYSLOG_DIR);
+  if (LittleFS.exists(SYSLOG_LEGACY))
+  {
+    //-- written by a firmware from before the segments
+    if (!found) adoptLegacyLog();
+    LittleFS.remove(SYSLOG_LEGACY);
+  }
+  sysLogReady = true;
+  DebugTf("sysLog segments [%u..%u], [%u] bytes in the last\r\n", segFirst, segLast, segSize);
+
+} // sysLogBegin()
+
+
+//=======================================================================
+//-- the next segment, the oldest go when there are more than allowed
+static void rotateSegments()
+{
+  char fName[30];
+
+  segLast++;
+  segSize = 0;
+  while ((segLast - segFirst) >= SYSLOG_SEGMENTS)
+  {
+    segmentName(fName, sizeof(fName), segFirst);
+    LittleFS.remove(fName);
+    segFirst++;
+  }
+
+} // rotateSegments()
+
+
+//=======================================================================
+//-- write the stage to the current segment (one open, write, close)
+void sysLogFlush()
+{
+  char fName[30];
+
+  if (logStageLen == 0 || !sysLogReady) return;
+  if (ESP.getFreeHeap() < 8500) // to prevent firmware from crashing!
+  {
+    ErrorTf("Bailout due to low heap (%d bytes)\r\n", ESP.getFreeHeap());
+    return;
+  }
+
+  uint32_t start = micros();
+  segmentName(fName, sizeof(fName), segLast);
+  File _file = LittleFS.open(fName, "a");
+  if (!_file)
+  {
+    ErrorTf("write(): could not open %s\r\n", fName);
+    return;
+  }
+  _file.write((const uint8_t*)logStage, logStageLen);
+  _file.close();
+  metricsFsOp(true, start);
+
+  segSize    += logStageLen;
+  logStageLen = 0;
+  if (segSize >= SYSLOG_SEGMENT_SIZE) rotateSegments();
+
+} // sysLogFlush()
+
+
+//=======================================================================
+//-- call from loop(): writes a stage that waited long enough
+void sysLogLoop()
+{
+  if (logStageLen > 0 && (millis() - logStageSince) > SYSLOG_FLUSH_MS) sysLogFlush();
+
+} // sysLogLoop()
+
+
+//=======================================================================
+uint32_t sysLogLost()
+{
+  return sysLogLostCnt;
+
+} // sysLogLost()
+
+
+//=======================================================================
+void writeToLog(const char *logLine)
+{
+  char buffer[SYSLOG_LINE_MAX] = "";
+  int  len = snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d; %02d:%02d:%02d; %s;\n"
+                                          , year(), month(), day()
+                                          , hour(), minute(), second()
+                                          , logLine);
+  if (len >= (int)sizeof(buffer))
+  {
+    len = sizeof(buffer) -1;
+    buffer[len -1] = '\n';    //-- cut, but still a line
+  }
+  DebugTf("writeToLog() => %s", buffer);
+
+  if ((logStageLen + len) > SYSLOG_STAGE_SIZE) sysLogFlush();
+  if ((logStageLen + len) > SYSLOG_STAGE_SIZE)
+  {
+    sysLogLostCnt++;          //-- could not be flushed (low heap)
+    return;
+  }
+  if (logStageLen == 0) logStageSince = millis();
+  memcpy(&logStage[logStageLen], buffer, len);
+  logStageLen += len;
+  if (logStageLen >= SYSLOG_FLUSH_SIZE) sysLogFlush();
+
+} // writeToLog()
+
+
+//=======================================================================
+//-- for a restart done by a library (firmware update, WiFiManager):
+//-- the reason is logged and the stage written
+void sysLogBeforeReboot(const char *reason)
+{
+  char line[SYSLOG_LINE_MAX];
+
+  snprintf(line, sizeof(line), "RESTART [%s]", reason);
+  writeToLog(line);
+  sysLogFlush();
+  DebugFlush();
+
+} // sysLogBeforeReboot()
+
+
+//=======================================================================
+//-- the only place that restarts the ESP
+void rebootDevice(const char *reason)
+{
+  sysLogBeforeReboot(reason);
+  delay(REBOOT_DELAY);
+  ESP.restart();
+  delay(5000);
+
+} // rebootDevice()
+
+
+//=======================================================================
+//-- '/api/v0/log': all segments, oldest first, and what is still staged
+void sendSysLog()
+{
+  char  fName[30];
+  char  buff[NET_CHUNK_SIZE];
+  int   len;
+
+  httpServer.sendHeader("Access-Control-Allow-Origin", "*");
+  httpServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  httpServer.send(200, "text/plain", "");
+
+  for (uint32_t seq = segFirst; seq <= segLast; seq++)
+  {
+    segmentName(fName, sizeof(fName), seq);
+    File _file = LittleFS.open(fName, "r");
+    if (!_file) continue;
+    while ((len = _file.read((uint8_t*)buff, sizeof(buff))) > 0)
+    {
+      httpServer.sendContent(buff, len);
+    }
+    _file.close();
+  }
+  if (logStageLen > 0) httpServer.sendContent(logStage, logStageLen);
+
+} // sendSysLog()
+
+
+/***************************************************************************
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the
+* "Software"), to deal in the Software without restriction, including
+* without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit
+* persons to whom the Software is furnished to do so, subject to the
+* following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT
+* OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR
+* THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*
+****************************************************************************
+*/
@@ -10,8 +10,18 @@
 ***************************************************************************      
 */
 
+#include <ezTime.h>
+
 //static time_t ntpTimeSav;
 
+//-- ezTime is not safe to use from two cores: with NET_TASK_CORE only the
+//-- network task calls it and timeSnapshot() (every pass of its loop)
+//-- keeps the second of the day for the display and the log on the other
+//-- core. One aligned word, so it is read whole without a lock.
+#ifdef NET_TASK_CORE
+static volatile uint32_t daySecond = 0;
+#endif
+
 //===========================================================================================
 String buildDateTimeString(const char* timeStamp, int len) 
 {
@@ -181,6 +191,49 @@ time_t epoch(const char *timeStamp, int8_t len, bool syncTime)
 } // epoch()
 
 
+//===========================================================================================
+void timeSnapshot()
+{
+#ifdef NET_TASK_CORE
+  daySecond = (hour() * 3600UL) + (minute() * 60UL) + second();
+#endif
+
+} // timeSnapshot()
+
+//===========================================================================================
+int8_t clockHour()
+{
+#ifdef NET_TASK_CORE
+  return daySecond / 3600;
+#else
+  return hour();
+#endif
+
+} // clockHour()
+
+//===========================================================================================
+int8_t clockMinute()
+{
+#ifdef NET_TASK_CORE
+  return (daySecond / 60) % 60;
+#else
+  return minute();
+#endif
+
+} // clockMinute()
+
+//===========================================================================================
+int8_t clockSecond()
+{
+#ifdef NET_TASK_CORE
+  return daySecond % 60;
+#else
+  return second();
+#endif
+
+} // clockSecond()
+
+
 /***************************************************************************
 *
 * Permission is hereby granted, free of charge, to any person obtaining a
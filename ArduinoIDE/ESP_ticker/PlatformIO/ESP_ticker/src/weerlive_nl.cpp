@@ -10,120 +10,130 @@
 ***************************************************************************      
 */
 
+static const char *weerliveHost = "weerlive.nl";
+static jsonScanner weerScanner;
+static char        weerValue[WEATHER_VALUE_SIZE];
+static WeatherData weather;
+
+//-- the fields of WeatherData that are looked for, keys match exactly
+typedef struct _weatherField {
+  const char  *key;
+  uint16_t     offset;
+  uint8_t      size;
+} weatherField;
+
+#define WEATHER_FIELD(k)  { #k, offsetof(WeatherData, k), sizeof(((WeatherData*)0)->k) }
+
+static const weatherField weatherFields[] = {
+    WEATHER_FIELD(plaats)
+  , WEATHER_FIELD(samenv)
+  , WEATHER_FIELD(luchtd)
+  , WEATHER_FIELD(d0tmin)
+  , WEATHER_FIELD(d0tmax)
+  , WEATHER_FIELD(d1weer)
+  , WEATHER_FIELD(d1tmin)
+  , WEATHER_FIELD(d1tmax)
+  , WEATHER_FIELD(fout)
+};
+#define WEATHER_FIELDS    (sizeof(weatherFields) / sizeof(weatherFields[0]))
+#define WEATHER_FOUND_ALL ((1 << (WEATHER_FIELDS -1)) -1)
+
+static void onWeerLiveDone(bool ok);
+
+//----------------------------------------------------------------------
+//-- called by the json scanner for every key/value in the response
+static bool onWeerLiveEvent(jsonScanner *js, uint8_t event)
+{
+  if (event != JSON_EV_VALUE) return true;
+
+  for (uint8_t f=0; f<WEATHER_FIELDS; f++)
+  {
+    if (weather.found & (1 << f))               continue;   //-- first one counts
+    if (strcmp(js->key, weatherFields[f].key))  continue;
+    strCopy((char*)&weather + weatherFields[f].offset, weatherFields[f].size, js->val);
+    weather.found |= (1 << f);
+    break;
+  }
+  //-- all fields (but 'fout') are in, the rest of the response is not needed
+  return (weather.found != WEATHER_FOUND_ALL);
+
+} // onWeerLiveEvent()
+
+
+//----------------------------------------------------------------------
+static bool onWeerLiveBody(const char *data, int len)
+{
+  return jsonScanFeed(&weerScanner, data, len);
+
+} // onWeerLiveBody()
+
+
+//----------------------------------------------------------------------
+//-- starts the fetch, fetchLoop() does the rest
 void getWeerLiveData() 
 {
-  const char* weerliveHost    = "weerlive.nl";
-  const int   httpPort        = 80;
-  int         weerliveStatus  = 0;
-  String      tempString;
-  int         startPos, endPos;
-  int32_t     maxWait;
-  char        jsonResponse[1536];
-  char        val[51] = "";
-  bool        gotData = false;
+  const int   httpPort        = FETCH_HTTPS_PORT;
+  char        url[FETCH_PATH_MAX];
   
-  WiFiClient weerliveClient;
-
   DebugTf("getWeerLiveData(%s)\r\n", weerliveHost);
 
   // We now create a URI for the request
-  String url = "/api/json-data-10min.php?key=";
-  url += settingWeerLiveAUTH;
-  url += "&locatie=";
-  url += settingWeerLiveLocation;
+  snprintf(url, sizeof(url), "/api/json-data-10min.php?key=%s&locatie=%s"
+                                        , settingWeerLiveAUTH, settingWeerLiveLocation);
 
   DebugTf("Requesting URL: %s/api/json-data-10min.php?key=secret&locatie=%s\r\n", weerliveHost, settingWeerLiveLocation);
-  Debugln(url);
-  if (!weerliveClient.connect(weerliveHost, httpPort)) 
-  {
-    DebugTln("connection failed");
-    sprintf(tempMessage, "connection to %s failed", weerliveHost);
-    weerliveClient.flush();
-    weerliveClient.stop();
-    return;
-  }
 
-  // This will send the request to the server
-  weerliveClient.print(String("GET ") + url + " HTTP/1.1\r\n" +
-               "Host: " + weerliveHost + "\r\n" + 
-               "Connection: close\r\n\r\n");
-  delay(10);
+  memset(&weather, 0, sizeof(weather));
+  jsonScanBegin(&weerScanner, weerValue, sizeof(weerValue), onWeerLiveEvent);
+  fetchStart(FETCH_WEERLIVE, weerliveHost, httpPort, url, onWeerLiveBody, onWeerLiveDone);
   
-  weerliveClient.setTimeout(5000);
+} // getWeerLiveData()
 
-  while ((weerliveClient.connected() || weerliveClient.available()) && !gotData)
+
+//----------------------------------------------------------------------
+static void onWeerLiveDone(bool ok)
+{
+  //-- the fetch stops reading as soon as all fields are found
+  if (strlen(weather.fout) > 0)
   {
-    yield();
-    while(weerliveClient.available() && !gotData)
+    ErrorTf("weerlive: %s\r\n", weather.fout);
+    schedDone(SCHED_WEATHER, false);
+    return;
+  }
+  //-- every field of the message, or the previous message stays
+  if ((weather.found & WEATHER_FOUND_ALL) != WEATHER_FOUND_ALL)
+  {
+    if (weather.found == 0 && fetchGetStats(FETCH_WEERLIVE)->httpStatus == 0)
     {
-      //--- skip to find HTTP/1.1
-      //--- then parse response code
-      if (weerliveClient.find("HTTP/1.1"))
-      {
-        weerliveStatus = weerliveClient.parseInt(); // parse status code
-        DebugTf("Statuscode: [%d] ", weerliveStatus); 
-        if (weerliveStatus != 200)
-        {
-          Debugln(" ERROR!");
-          weerliveClient.flush();
-          weerliveClient.stop();
-          return;  
-        }
-        Debugln(" OK!");
-      }
-      else
-      {
-        DebugTln("Error reading weerLive.. -> bailout!");
-        weerliveClient.flush();
-        weerliveClient.stop();
-        return;
-      }
-      //--- skip headers
-      if (weerliveClient.find("\r\n\r\n"))
-      {
-        int charsRead = 0;
-        charsRead = weerliveClient.readBytesUntil('\0',  jsonResponse, sizeof(jsonResponse));
-        jsonResponse[(charsRead -1)] = '\0';
-        gotData = true;
-        DebugTln("Got weer data!");
-      }
-    } // while available ..
-    
-  } // connected ..
-
-  weerliveClient.flush();
-  weerliveClient.stop();
-  //-- jsonResponse looks like:
+      sprintf(tempMessage, "connection to %s failed", weerliveHost);
+    }
+    else ErrorTf("incomplete weather data [%s] found[0x%02x]\r\n", (ok ? "OK" : "FAILED"), weather.found);
+    schedDone(SCHED_WEATHER, false);
+    return;
+  }
+  if (strlen(weather.plaats) == 0)
+  {
+    ErrorTf("no weather data in response\r\n");
+    schedDone(SCHED_WEATHER, false);
+    return;
+  }
+  schedDone(SCHED_WEATHER, true);
+  DebugTln("Got weer data!");
+
+  //-- the response looks like:
   //-- { "liveweer": [{"plaats": "Baarn", "timestamp": "1683105785", "time": "03-05-2023 11:23", "temp": "10.4", "gtemp": "8.8", "samenv": "Licht bewolkt", "lv": "56", "windr": "NO", "windrgr": "44", "windms": "3", "winds": "2", "windk": "5.8", "windkmh": "10.8", "luchtd": "1029.4", "ldmmhg": "772", "dauwp": "2", "zicht": "35", "verw": "Zonnig en droog, donderdag warmer", "sup": "06:03", "sunder": "21:08", "image": "lichtbewolkt", "d0weer": "halfbewolkt", "d0tmax": "15", "d0tmin": "3", "d0windk": "2", "d0windknp": "6", "d0windms": "3", "d0windkmh": "11", "d0windr": "NO", "d0windrgr": "44", "d0neerslag": "0", "d0zon": "35", "d1weer": "halfbewolkt", "d1tmax": "20", "d1tmin": "5", "d1windk": "2", "d1windknp": "6", "d1windms": "3", "d1windkmh": "11", "d1windr": "O", "d1windrgr": "90", "d1neerslag": "20", "d1zon": "60", "d2weer": "regen", "d2tmax": "19", "d2tmin": "12", "d2windk": "2", "d2windknp": "6", "d2windms": "3", "d2windkmh": "11", "d2windr": "ZW", "d2windrgr": "225", "d2neerslag": "80", "d2zon": "30", "alarm": "0", "alarmtxt": ""}]}
-  
-  int prevLength = strlen(jsonResponse);
-  strTrimCntr(jsonResponse, 1534);
-  DebugTf("jsonResponse now [%d]chars (before trim [%d]chars)\r\n", strlen(jsonResponse), prevLength);
-  DebugTf("jsonResponse is [%s]\r\n\n", jsonResponse);
-  
-  parseJsonKey(jsonResponse, "plaats", val, 50);
-  snprintf(tempMessage, LOCAL_SIZE, val);
-  parseJsonKey(jsonResponse, "samenv", val, 50);
-  snprintf(cMsg, LOCAL_SIZE, " %s %s ", tempMessage, val);
-  parseJsonKey(jsonResponse, "d0tmin", val, 50);
-  snprintf(tempMessage, LOCAL_SIZE, "%s min %s°C ", cMsg, val);
-  parseJsonKey(jsonResponse, "d0tmax", val, 50);
-  snprintf(cMsg, LOCAL_SIZE, "%s max %s°C", tempMessage, val);
-  parseJsonKey(jsonResponse, "luchtd", val, 50);
-  snprintf(tempMessage, LOCAL_SIZE, "%s - luchtdruk %s hPa ", cMsg, val);
-
-  parseJsonKey(jsonResponse, "d1weer", val, 50);
-  snprintf(cMsg, LOCAL_SIZE, "%s - morgen %s ", tempMessage, val);
-  parseJsonKey(jsonResponse, "d1tmin", val, 50);
-  snprintf(tempMessage, LOCAL_SIZE, "%s min %s°C ", cMsg, val);
-  parseJsonKey(jsonResponse, "d1tmax", val, 50);
-  snprintf(cMsg, LOCAL_SIZE, "%s max %s°C", tempMessage, val);
-
-  snprintf(tempMessage, LOCAL_SIZE, "%s", cMsg);
+  snprintf(tempMessage, LOCAL_SIZE, " %s %s  min %s°C  max %s°C - luchtdruk %s hPa  - morgen %s  min %s°C  max %s°C"
+                                  , weather.plaats, weather.samenv
+                                  , weather.d0tmin, weather.d0tmax
+                                  , weather.luchtd
+                                  , weather.d1weer
+                                  , weather.d1tmin, weather.d1tmax);
+  utf8ToLatin1(tempMessage);    //-- once, not every time it is shown
+  writeLastWeather(tempMessage);
   Debugln("\r\n");
   Debugf("\tWeer[%s]\r\n", tempMessage);
   
-} // getWeerLiveData()
+} // onWeerLiveDone()
 
 
 /***************************************************************************
@@ -16,6 +16,9 @@ import re
 import argparse
 import logging
 import traceback
+import hashlib
+import json
+import tempfile
 from datetime import datetime
 
 global_extern_declarations = set()
@@ -104,7 +107,7 @@ def copy_data_folder(project_folder, pio_folder):
         logging.info("No data folder found in the project folder")
 
 #------------------------------------------------------------------------------------------------------
-def create_platformio_ini(pio_folder):
+def create_platformio_ini(pio_folder, use_pch=False):
     """Create a platformio.ini file if it doesn't exist."""
     platformio_ini_path = os.path.join(pio_folder, 'platformio.ini')
     if not os.path.exists(platformio_ini_path):
@@ -133,7 +136,7 @@ upload_speed = 115200
 upload_port = <select port like "/dev/cu.usbserial-3224144">
 build_flags =
 \t-D DEBUG
-
+{extra_scripts}
 lib_ldf_mode = deep+
 
 lib_deps =
@@ -142,6 +145,8 @@ lib_deps =
 monitor_filters =
   esp8266_exception_decoder
 """
+        extra_scripts = "extra_scripts = post:pchBuild.py\n" if use_pch else ""
+        platformio_ini_content = platformio_ini_content.replace("{extra_scripts}", extra_scripts)
         with open(platformio_ini_path, 'w') as f:
             f.write(platformio_ini_content)
         logging.info(f"Created platformio.ini file at {platformio_ini_path}")
@@ -281,7 +286,7 @@ def create_header_file(header_path, base_name):
 
 #------------------------------------------------------------------------------------------------------
 def create_header_files(pio_src, pio_include, project_name):
-    for file in os.listdir(pio_src):
+    for file in sorted(os.listdir(pio_src)):
         if file.endswith('.ino') and file != f"{project_name}.ino":
             base_name = os.path.splitext(file)[0]
             header_path = os.path.join(pio_include, f"{base_name}.h")
@@ -389,10 +394,36 @@ def copy_project_files(project_folder, pio_src, pio_include):
 
 
 #------------------------------------------------------------------------------------------------------
-def extract_global_vars(pio_src, pio_include, project_name):
+def scan_key(kind, file, content):
+    """Key of a scan result in the cache: the pass, the file and the hash of its content."""
+    return f"{kind}:{file}:{hashlib.sha256(content.encode('utf-8')).hexdigest()}"
+
+#------------------------------------------------------------------------------------------------------
+def scan_cache_lookup(scan_cache, key):
+    """
+    Look up a scan result of the previous run.
+    A result that is found is kept for the next run, the others are dropped.
+
+    Returns:
+        tuple: (found, result)
+    """
+    if scan_cache is None or key not in scan_cache['old']:
+        return False, None
+    scan_cache['new'][key] = scan_cache['old'][key]
+    return True, scan_cache['old'][key]
+
+#------------------------------------------------------------------------------------------------------
+def scan_cache_store(scan_cache, key, result):
+    """Store the scan result of a file for the next run."""
+    if scan_cache is not None:
+        scan_cache['new'][key] = result
+
+#------------------------------------------------------------------------------------------------------
+def extract_global_vars(pio_src, pio_include, project_name, scan_cache=None):
     """
     Extract global variable definitions from .ino files and the main project header file.
     Only variables declared outside of all function blocks are considered global.
+    With a scan_cache a file with the same content as in the previous run is not scanned again.
     """
     global_vars = {}
 
@@ -406,7 +437,7 @@ def extract_global_vars(pio_src, pio_include, project_name):
                     'break', 'continue', 'return', 'goto', 'typedef', 'struct', 'enum',
                     'union', 'sizeof', 'volatile', 'register', 'extern', 'inline'])
 
-    files_to_process = [f for f in os.listdir(pio_src) if f.endswith('.ino') or f.endswith('.cpp')]
+    files_to_process = [f for f in sorted(os.listdir(pio_src)) if f.endswith('.ino') or f.endswith('.cpp')]
     main_ino = f"{project_name}.ino"
     if main_ino not in files_to_process and os.path.exists(os.path.join(pio_src, main_ino)):
         files_to_process.append(main_ino)
@@ -428,6 +459,13 @@ def extract_global_vars(pio_src, pio_include, project_name):
             with open(file_path, 'r') as f:
                 content = f.read()
 
+            key = scan_key('globals', file, content)
+            found, cached = scan_cache_lookup(scan_cache, key)
+            if found:
+                global_vars[file] = [tuple(v) for v in cached]
+                logging.info(f"Unchanged {file}, {len(cached)} global variables from the cache.")
+                continue
+
             # Remove comments while preserving string literals
             content = remove_comments_preserve_strings(content)
 
@@ -463,6 +501,7 @@ def extract_global_vars(pio_src, pio_include, project_name):
                                 logging.debug(f"Found global variable in {file}:{line_num}: {var_type} {var_name}")
 
             global_vars[file] = file_vars
+            scan_cache_store(scan_cache, key, file_vars)
             logging.info(f"Processed {file} successfully. Found {len(file_vars)} global variables.")
 
         except Exception as e:
@@ -473,10 +512,11 @@ def extract_global_vars(pio_src, pio_include, project_name):
     return global_vars
 
 #------------------------------------------------------------------------------------------------------
-def extract_class_instances(pio_src, pio_include, project_name):
+def extract_class_instances(pio_src, pio_include, project_name, scan_cache=None):
     """
     Extract class instance definitions from .ino, .cpp, and .h files.
     Only global class instance declarations are considered.
+    With a scan_cache a file with the same content as in the previous run is not scanned again.
     """
     class_instances = {}
     
@@ -496,8 +536,8 @@ def extract_class_instances(pio_src, pio_include, project_name):
     # Common class suffixes
     common_suffixes = ['Client', 'Server', 'Class', 'Manager', 'Handler', 'Controller', 'Service', 'Factory', 'Builder']
     
-    files_to_process = [f for f in os.listdir(pio_src) if f.endswith(('.ino', '.cpp'))]
-    files_to_process += [f for f in os.listdir(pio_include) if f.endswith('.h')]
+    files_to_process = [f for f in sorted(os.listdir(pio_src)) if f.endswith(('.ino', '.cpp'))]
+    files_to_process += [f for f in sorted(os.listdir(pio_include)) if f.endswith('.h')]
     
     for file in files_to_process:
         if file.endswith(('.ino', '.cpp')):
@@ -509,6 +549,14 @@ def extract_class_instances(pio_src, pio_include, project_name):
         try:
             with open(file_path, 'r') as f:
                 content = f.read()
+
+                key = scan_key('classes', file, content)
+                found, cached = scan_cache_lookup(scan_cache, key)
+                if found:
+                    if cached is not None:
+                        class_instances[file] = [tuple(i) for i in cached]
+                    logging.info(f"Unchanged {file}, class instances from the cache.")
+                    continue
                     
                 # Remove comments while preserving string literals
                 content = remove_comments_preserve_strings(content)
@@ -550,6 +598,8 @@ def extract_class_instances(pio_src, pio_include, project_name):
                                 logging.info(f"Processed {file} successfully. Found {len(file_instances)} class instances.")
                             else:
                                 logging.info(f"Processed {file} successfully. No class instances found.")
+
+                scan_cache_store(scan_cache, key, class_instances.get(file))
                                     
         except Exception as e:
             logging.error(f"Error processing file {file}: {str(e)}")
@@ -681,17 +731,22 @@ def update_header_with_prototypes(header_path, prototypes):
     logging.info(f"Updated header {header_path} with {len(new_prototypes)} new Function Prototypes")
 
 #------------------------------------------------------------------------------------------------------
-def process_function_references(pio_src, pio_include):
+def collect_function_references(pio_include):
+    """{function name: header file} for all function prototypes in the header files."""
     function_reference_array = {}
-
-    # Collect all function prototypes from header files
-    for file in os.listdir(pio_include):
+    for file in sorted(os.listdir(pio_include)):
         if file.endswith('.h'):
             with open(os.path.join(pio_include, file), 'r') as f:
                 content = f.read()
             prototypes = re.findall(r'^\w+[\s\*]+(\w+)\s*\([^)]*\);', content, re.MULTILINE)
             for func_name in prototypes:
                 function_reference_array[func_name] = file
+    return function_reference_array
+
+#------------------------------------------------------------------------------------------------------
+def process_function_references(pio_src, pio_include):
+    # Collect all function prototypes from header files
+    function_reference_array = collect_function_references(pio_include)
 
     # Print the function reference array
     print("Function Reference Array:")
@@ -699,7 +754,7 @@ def process_function_references(pio_src, pio_include):
         print(f"{func}: {file}")
 
     # Process .ino files
-    for file in os.listdir(pio_src):
+    for file in sorted(os.listdir(pio_src)):
         if file.endswith('.ino') or file.endswith('.cpp'):
             base_name = os.path.splitext(file)[0]
             source_path = os.path.join(pio_src, file)
@@ -730,7 +785,7 @@ def process_function_references(pio_src, pio_include):
                 local_headers_pos = next((i for i, line in enumerate(header_content) if "//== Local Headers ==" in line), -1)
                 if local_headers_pos != -1:
                     insert_pos = local_headers_pos + 1
-                    new_includes = [f'#include "{header}"\n' for header in headers_to_include if header != f"{base_name}.h"]
+                    new_includes = [f'#include "{header}"\n' for header in sorted(headers_to_include) if header != f"{base_name}.h"]
                     header_content[insert_pos:insert_pos] = new_includes
 
                     with open(header_path, 'w') as f:
@@ -741,7 +796,7 @@ def process_function_references(pio_src, pio_include):
     logging.info("Processed function references and updated header files")
 
 #------------------------------------------------------------------------------------------------------
-def process_ino_files(pio_src, pio_include, project_name, global_vars, class_instances):
+def process_ino_files(pio_src, pio_include, project_name, global_vars, class_instances, minimal_includes=False):
     global global_extern_declarations
     global_extern_declarations = set()  # Reset global extern declarations
 
@@ -750,7 +805,7 @@ def process_ino_files(pio_src, pio_include, project_name, global_vars, class_ins
     main_ino = f"{project_name}.ino"
     main_ino_path = os.path.join(pio_src, main_ino)
 
-    files_to_process = [f for f in os.listdir(pio_src) if f.endswith('.ino')]
+    files_to_process = [f for f in sorted(os.listdir(pio_src)) if f.endswith('.ino')]
     if main_ino not in files_to_process and os.path.exists(main_ino_path):
         files_to_process.append(main_ino)
 
@@ -760,11 +815,19 @@ def process_ino_files(pio_src, pio_include, project_name, global_vars, class_ins
         base_name = os.path.splitext(file)[0]
         header_path = os.path.join(pio_include, f"{base_name}.h")
         source_path = os.path.join(pio_src, file)
+        if minimal_includes and file == main_ino:
+            # The project header is restored from the original later on, the prototypes
+            # of the main file get a header of their own so other files don't need
+            # the (heavy) project header for them
+            header_path = os.path.join(pio_include, f"{base_name}Functions.h")
+            base_name_header = f"{base_name}Functions"
+        else:
+            base_name_header = base_name
 
         logging.info(f"Processing file: {source_path}, header_path {header_path}")
 
         # Create the header file if it doesn't exist
-        create_header_file(header_path, base_name)
+        create_header_file(header_path, base_name_header)
 
         with open(source_path, 'r') as f:
             content = f.read()
@@ -821,7 +884,7 @@ def update_project_header(pio_include, project_name, original_content):
         if section.strip() == "//== Local Headers ==":
             # Add new local includes here
             new_content.append(section + "\n")
-            for file in os.listdir(pio_include):
+            for file in sorted(os.listdir(pio_include)):
                 if file.endswith('.h') and file != f"{project_name}.h":
                     include_line = f'#include "{file}"\n'
                     if include_line not in original_content:
@@ -842,6 +905,247 @@ def update_project_header(pio_include, project_name, original_content):
     logging.info(f"Updated project header {project_name}.h while preserving original content")
 
 
+#------------------------------------------------------------------------------------------------------
+# What the libraries the converter knows about declare. Other library headers are
+# needed when their name is used (<WiFiManager.h> -> WiFiManager), if not they are
+# included everywhere, as before. A name ending in '_' is a prefix.
+LIBRARY_SYMBOLS = {
+    'ESP8266WiFi.h':      ['WiFi', 'WiFiClient', 'WiFiServer', 'WiFiClientSecure', 'IPAddress',
+                           'WL_', 'WIFI_', 'wl_status_t'],
+    'ESP8266WebServer.h': ['ESP8266WebServer', 'HTTPMethod', 'HTTPUpload', 'HTTP_', 'UPLOAD_FILE_',
+                           'CONTENT_LENGTH_'],
+    'ESP8266mDNS.h':      ['MDNS'],
+    'WiFiUdp.h':          ['WiFiUDP'],
+    'LittleFS.h':         ['LittleFS', 'File', 'Dir', 'FSInfo'],
+    'FS.h':               ['SPIFFS', 'File', 'Dir', 'FSInfo'],
+    'SPI.h':              ['SPI'],
+    'Wire.h':             ['Wire'],
+    'ezTime.h':           ['Timezone', 'UTC', 'events', 'timeStatus', 'timeSet', 'timeNotSet', 'setDebug',
+                           'waitForSync', 'setInterval', 'now', 'hour', 'minute', 'second', 'day',
+                           'weekday', 'month', 'year', 'INFO', 'NONE', 'ERROR', 'DEBUG'],
+    'TimeLib.h':          ['time_t', 'now', 'hour', 'minute', 'second', 'day', 'weekday', 'month', 'year',
+                           'setTime', 'tmElements_t'],
+    'MD_Parola.h':        ['MD_Parola', 'textEffect_t', 'textPosition_t', 'PA_'],
+    'MD_MAX72xx.h':       ['MD_MAX72XX'],
+    'WiFiManager.h':      ['WiFiManager'],
+    'ModUpdateServer.h':  ['ESP8266HTTPUpdateServer'],
+    'ESP8266HTTPUpdateServer.h': ['ESP8266HTTPUpdateServer'],
+    'TelnetStream.h':     ['TelnetStream'],
+    'ArduinoJson.h':      ['JsonDocument', 'DynamicJsonDocument', 'StaticJsonDocument', 'JsonObject',
+                           'JsonArray', 'serializeJson', 'deserializeJson', 'DeserializationError'],
+}
+
+CPP_KEYWORDS = set(['if', 'else', 'for', 'while', 'do', 'switch', 'case', 'default', 'break',
+                    'continue', 'return', 'goto', 'typedef', 'struct', 'enum', 'union', 'sizeof',
+                    'volatile', 'register', 'extern', 'inline', 'static', 'const', 'class'])
+
+#------------------------------------------------------------------------------------------------------
+def header_symbols(content):
+    """
+    Names a project header defines: (types, values).
+    types are classes/structs/enums/typedefs, macros and functions with a body,
+    values are the variables and objects. An over-estimate only costs an include.
+    """
+    content = remove_comments(content)
+    types = set(re.findall(r'^\s*#define\s+(\w+)', content, re.MULTILINE))
+    types |= set(re.findall(r'\b(?:class|struct|enum|union)\s+(\w+)', content))
+    types |= set(re.findall(r'\btypedef\b[^;]*?(\w+)\s*;', content))
+    types |= set(re.findall(r'\b(\w+)\s*\([^;{)]*\)\s*(?:const\s*)?\{', content))
+    values = set(re.findall(r'^\s*(?:(?:static|const|volatile|unsigned|signed)\s+)*[A-Za-z_][\w:<>]*[\s\*&]+(\w+)'
+                            r'\s*(?:\[[^\]]*\])*(?:\s+[A-Z_]+)*\s*(?:=|;|\()', content, re.MULTILINE))
+    return types - CPP_KEYWORDS, values - CPP_KEYWORDS - types
+
+#------------------------------------------------------------------------------------------------------
+def collect_project_includes(pio_include, content, seen=None):
+    """
+    The #include's of the project header, and of the project headers it includes,
+    as a list of (name, is_library). Project headers are followed, library headers not.
+    """
+    if seen is None:
+        seen = set()
+    includes = []
+    for match in re.finditer(r'^\s*#include\s*([<"])([^>"]+)[>"]', remove_comments(content), re.MULTILINE):
+        name = match.group(2).strip()
+        if name in seen or name in ('Arduino.h', 'allDefines.h'):
+            continue
+        seen.add(name)
+        path = os.path.join(pio_include, name)
+        if match.group(1) == '"' and os.path.exists(path):
+            includes.append((name, False))
+            with open(path, 'r') as f:
+                includes += collect_project_includes(pio_include, f.read(), seen)
+        else:
+            includes.append((name, True))
+    return includes
+
+#------------------------------------------------------------------------------------------------------
+def library_needed(name, words):
+    """True if words use something from library header name, None if we can't tell."""
+    base_name = os.path.splitext(os.path.basename(name))[0]
+    symbols = LIBRARY_SYMBOLS.get(name)
+    if symbols is None:
+        return True if base_name in words else None
+    for symbol in symbols:
+        if symbol.endswith('_'):
+            if any(word.startswith(symbol) for word in words):
+                return True
+        elif symbol in words:
+            return True
+    return False
+
+#------------------------------------------------------------------------------------------------------
+def insert_includes(content, marker, include_lines):
+    """Insert include_lines on the line after marker (or at the end of the header guard)."""
+    lines = content.split('\n')
+    pos = next((i + 1 for i, line in enumerate(lines) if line.strip().startswith(marker)), None)
+    if pos is None:
+        pos = next((i + 1 for i, line in enumerate(lines) if line.startswith('#define')), 0)
+    lines[pos:pos] = include_lines
+    return '\n'.join(lines)
+
+#------------------------------------------------------------------------------------------------------
+def minimize_includes(pio_folder, pio_src, pio_include, project_name, original_content, use_pch=False):
+    """
+    Give every generated header only the includes its own .cpp and declarations use,
+    instead of the project header that pulls in all libraries (and the font tables ..)
+    for every translation unit. With use_pch the libraries used by more than one file
+    go into a header that is precompiled by pchBuild.py.
+    """
+    project_header = f"{project_name}.h"
+    candidates = collect_project_includes(pio_include, original_content)
+    project_types, _ = header_symbols(original_content)
+
+    provides = {}
+    for name, is_library in candidates:
+        if not is_library:
+            with open(os.path.join(pio_include, name), 'r') as f:
+                types, values = header_symbols(f.read())
+            provides[name] = types | values
+
+    function_reference_array = collect_function_references(pio_include)
+    library_users = {}
+    headers_done = {}
+
+    for file in sorted(os.listdir(pio_src)):
+        if not file.endswith('.cpp'):
+            continue
+        base_name = os.path.splitext(file)[0]
+        source_path = os.path.join(pio_src, file)
+        with open(source_path, 'r') as f:
+            source = f.read()
+
+        if base_name == project_name:
+            # The project header stays complete for the main file, it only misses the
+            # headers of the functions it calls (the project header has no marker for them)
+            function_calls = set(re.findall(r'\b(\w+)\s*\(', remove_comments(source)))
+            headers = sorted(set(function_reference_array[func] for func in function_calls
+                                 if func in function_reference_array) - {project_header})
+            new_includes = [f'#include "{h}"' for h in headers if f'#include "{h}"' not in source]
+            if new_includes:
+                source = insert_includes(source, f'#include "{project_header}"', new_includes)
+                with open(source_path, 'w') as f:
+                    f.write(source)
+            # its prototypes are all the functions header needs
+            headers_done[f"{project_name}Functions.h"] = ""
+            continue
+        headers_done[f"{base_name}.h"] = remove_comments(source)
+
+    for header, source in headers_done.items():
+        header_path = os.path.join(pio_include, header)
+        if not os.path.exists(header_path):
+            continue
+        with open(header_path, 'r') as f:
+            content = f.read()
+        words = set(re.findall(r'\b(\w+)\b', source + remove_comments(content)))
+        # a global with an extern here does not need the header that defines it
+        externs = set(re.findall(r'\bextern\b[^;]*?(\w+)\s*(?:\[\s*\])?\s*;', content))
+
+        # the project header only for the types it defines, its variables have an extern here
+        if (project_types & words) and header != f"{project_name}Functions.h":
+            keep_project_header = True
+        else:
+            keep_project_header = False
+            content = content.replace(f'#include "{project_header}"\n', '')
+
+        libraries, locals_ = [], []
+        for name, is_library in candidates:
+            if f'#include <{name}>' in content or f'#include "{name}"' in content:
+                continue
+            if is_library:
+                needed = library_needed(name, words)
+                if needed is None:
+                    needed = True       # unknown library: as before, it is everywhere
+            else:
+                needed = bool(provides[name] & (words - externs)) and not keep_project_header
+            if not needed:
+                continue
+            if is_library:
+                libraries.append(f'#include <{name}>')
+                library_users.setdefault(name, set()).add(header)
+            else:
+                locals_.append(f'#include "{name}"')
+
+        content = insert_includes(content, '#include <Arduino.h>', libraries)
+        content = insert_includes(content, '//== Local Headers ==', locals_)
+        with open(header_path, 'w') as f:
+            f.write(content)
+        logging.info(f"{header}: {len(libraries)} library and {len(locals_)} local includes"
+                     f"{' (and ' + project_header + ')' if keep_project_header else ''}")
+
+    if use_pch:
+        create_pch(pio_folder, pio_src, pio_include, project_name,
+                   sorted(name for name, users in library_users.items() if len(users) > 1))
+
+    logging.info("Minimized the includes of the generated headers")
+
+#------------------------------------------------------------------------------------------------------
+PCH_BUILD_SCRIPT = """#
+#  pchBuild.py - PlatformIO (post) extra_script, created by arduinoIDE2platformIO.py
+#
+#  Precompiles include/{pch} with the flags of the project sources. Every
+#  .cpp includes it first; when the .gch is missing or does not fit the
+#  flags, the compiler just reads the header.
+#
+import os
+import subprocess
+
+Import("env", "projenv")
+
+pch = os.path.join(env.subst("$PROJECT_INCLUDE_DIR"), "{pch}")
+gch = pch + ".gch"
+projenv.Append(CCFLAGS=["-Winvalid-pch"])
+
+if not os.path.isfile(gch) or os.path.getmtime(gch) < os.path.getmtime(pch):
+  cmd = projenv.subst("$CXX -x c++-header -o \\"%s\\" -c $CXXFLAGS $CCFLAGS $_CCCOMCOM \\"%s\\"" % (gch, pch))
+  print("pchBuild: %s" % os.path.basename(gch))
+  if subprocess.call(cmd, shell=True, env=projenv["ENV"]) != 0:
+    print("pchBuild: failed, building without precompiled header")
+"""
+
+#------------------------------------------------------------------------------------------------------
+def create_pch(pio_folder, pio_src, pio_include, project_name, libraries):
+    """The libraries used by more than one file in one precompiled header, included first by every .cpp."""
+    pch_name = f"{project_name}Pch.h"
+    guard = f"{project_name.upper()}PCH_H"
+    with open(os.path.join(pio_include, pch_name), 'w') as f:
+        f.write(f"#ifndef {guard}\n#define {guard}\n\n#include <Arduino.h>\n")
+        for name in libraries:
+            f.write(f"#include <{name}>\n")
+        f.write(f"\n#endif // {guard}\n")
+
+    for file in sorted(os.listdir(pio_src)):
+        if file.endswith('.cpp'):
+            source_path = os.path.join(pio_src, file)
+            with open(source_path, 'r') as f:
+                content = f.read()
+            if f'#include "{pch_name}"' not in content:
+                with open(source_path, 'w') as f:
+                    f.write(f'#include "{pch_name}"\n{content}')
+
+    with open(os.path.join(pio_folder, "pchBuild.py"), 'w') as f:
+        f.write(PCH_BUILD_SCRIPT.replace("{pch}", pch_name))
+    logging.info(f"Created {pch_name} with {len(libraries)} libraries and pchBuild.py")
+
 #------------------------------------------------------------------------------------------------------
 def print_global_vars(global_vars):
     """Print the dictionary of global variables."""
@@ -866,6 +1170,12 @@ def parse_arguments():
     parser.add_argument("--project_dir", default=os.getcwd(), help="Path to the project directory")
     parser.add_argument("--backup", action="store_true", help="Create a backup of original files")
     parser.add_argument("--debug", action="store_true", help="Enable debug logging")
+    parser.add_argument("--minimal_includes", action="store_true",
+                        help="Generated headers only include what their file uses")
+    parser.add_argument("--pch", action="store_true",
+                        help="With --minimal_includes: precompile the shared libraries (pchBuild.py)")
+    parser.add_argument("--incremental", action="store_true",
+                        help=f"Only write the files that changed, cache in PlatformIO/<project>/{CACHE_FILE}")
     return parser.parse_args()
 
 
@@ -877,14 +1187,182 @@ def setup_logging(debug=False):
         format='%(levelname)s - %(filename)s:%(lineno)d - %(message)s'
     )
 
+#------------------------------------------------------------------------------------------------------
+def convert_project(project_folder, project_name, pio_folder, pio_src, pio_include, args, scan_cache=None):
+    """Convert the Arduino project into the (empty) src and include folders of pio_folder."""
+    copy_project_files(project_folder, pio_src, pio_include)
+    copy_data_folder(project_folder, pio_folder)
+    create_platformio_ini(pio_folder, args.minimal_includes and args.pch)
+    extract_and_comment_defines(pio_folder, pio_include)
+    create_header_files(pio_src, pio_include, project_name)
+
+    original_header_content = preserve_original_header(pio_include, project_name)
+    #logging.info(f"original {project_name}.h:\n{original_header_content}\n\n")
+
+    global_vars = extract_global_vars(pio_src, pio_include, project_name, scan_cache)
+    class_instances = extract_class_instances(pio_src, pio_include, project_name, scan_cache)
+    logging.debug(f"Extracted global vars: {global_vars}")
+    print_global_vars(global_vars)
+    logging.debug(f"Extracted class instances: {class_instances}")
+    print_class_instances(class_instances)
+
+    process_ino_files(pio_src, pio_include, project_name, global_vars, class_instances,
+                      args.minimal_includes)
+
+    process_function_references(pio_src, pio_include)
+
+    # Process the main project header file last
+    ##original_header_content = preserve_original_header(pio_include, project_name)
+    #logging.info(f"original {project_name}.h:\n{original_header_content}\n\n")
+    update_project_header(pio_include, project_name, original_header_content)
+    main_header_path = os.path.join(pio_include, f"{project_name}.h")
+    fix_main_header_file(main_header_path, project_name)
+
+    if args.minimal_includes:
+        minimize_includes(pio_folder, pio_src, pio_include, project_name,
+                          original_header_content, args.pch)
+
+
+#------------------------------------------------------------------------------------------------------
+CACHE_FILE = ".arduinoIDE2platformIO.json"
+CACHE_VERSION = 1
+# created once, after that they belong to the user and are never overwritten
+KEEP_IF_EXISTS = set(['platformio.ini'])
+
+#------------------------------------------------------------------------------------------------------
+def file_hash(path):
+    with open(path, 'rb') as f:
+        return hashlib.sha256(f.read()).hexdigest()
+
+#------------------------------------------------------------------------------------------------------
+def input_hashes(project_folder):
+    """{relative path: hash} of everything the conversion reads: the .ino and .h files and the data folder."""
+    inputs = {}
+    for file in os.listdir(project_folder):
+        if file.endswith(('.ino', '.h')):
+            inputs[file] = file_hash(os.path.join(project_folder, file))
+    data_folder = os.path.join(project_folder, 'data')
+    for root, dirs, files in os.walk(data_folder):
+        for file in files:
+            path = os.path.join(root, file)
+            inputs[os.path.relpath(path, project_folder).replace(os.sep, '/')] = file_hash(path)
+    return inputs
+
+#------------------------------------------------------------------------------------------------------
+def tree_hashes(folder):
+    """{relative path: hash} of all files in folder."""
+    hashes = {}
+    for root, dirs, files in os.walk(folder):
+        for file in files:
+            path = os.path.join(root, file)
+            hashes[os.path.relpath(path, folder).replace(os.sep, '/')] = file_hash(path)
+    return hashes
+
+#------------------------------------------------------------------------------------------------------
+def outputs_intact(pio_folder, outputs):
+    """True when every output of the previous run is still there, unchanged."""
+    for rel_path, digest in outputs.items():
+        path = os.path.join(pio_folder, rel_path)
+        if not os.path.isfile(path) or file_hash(path) != digest:
+            return False
+    return True
+
+#------------------------------------------------------------------------------------------------------
+def load_cache(cache_path):
+    try:
+        with open(cache_path, 'r') as f:
+            cache = json.load(f)
+        if cache.get('version') == CACHE_VERSION:
+            return cache
+        logging.info(f"Cache {cache_path} is from another version, not used")
+    except FileNotFoundError:
+        pass
+    except (ValueError, OSError) as e:
+        logging.warning(f"Cache {cache_path} not used: {str(e)}")
+    return {}
+
+#------------------------------------------------------------------------------------------------------
+def sync_tree(stage_folder, pio_folder, old_outputs):
+    """
+    Copy the files of stage_folder that differ to pio_folder, leave the others untouched
+    (so their timestamps, and the PlatformIO build cache, stay valid) and remove the outputs
+    of the previous run that are no longer generated.
+
+    Returns:
+        dict: {relative path: hash} of the outputs of this run
+    """
+    outputs = tree_hashes(stage_folder)
+    written = 0
+    for rel_path, digest in sorted(outputs.items()):
+        target = os.path.join(pio_folder, rel_path)
+        if os.path.basename(rel_path) in KEEP_IF_EXISTS and os.path.exists(target):
+            continue
+        if os.path.isfile(target) and file_hash(target) == digest:
+            continue
+        os.makedirs(os.path.dirname(target), exist_ok=True)
+        shutil.copyfile(os.path.join(stage_folder, rel_path), target)
+        logging.info(f"Updated {rel_path}")
+        written += 1
+
+    for rel_path in sorted(set(old_outputs) - set(outputs)):
+        target = os.path.join(pio_folder, rel_path)
+        if os.path.isfile(target):
+            os.remove(target)
+            logging.info(f"Removed {rel_path}, it is no longer generated")
+
+    unchanged = len(outputs) - written
+    logging.info(f"{written} files updated, {unchanged} unchanged")
+    return {p: d for p, d in outputs.items() if os.path.basename(p) not in KEEP_IF_EXISTS}
+
+#------------------------------------------------------------------------------------------------------
+def convert_incremental(project_folder, project_name, pio_folder, args):
+    """
+    Convert into a staging folder and only write the files that changed to pio_folder.
+    The hashes of the inputs and outputs, and the per file scan results, are kept in CACHE_FILE;
+    when nothing changed since the previous run the conversion is skipped.
+    """
+    cache_path = os.path.join(pio_folder, CACHE_FILE)
+    cache = load_cache(cache_path)
+    inputs = input_hashes(project_folder)
+    options = {'script': file_hash(os.path.abspath(__file__)),
+               'minimal_includes': args.minimal_includes, 'pch': args.pch}
+    old_inputs = cache.get('inputs', {})
+    old_outputs = cache.get('outputs', {})
+
+    if cache.get('options') == options and old_inputs == inputs and outputs_intact(pio_folder, old_outputs):
+        logging.info("Nothing changed since the previous conversion")
+        return
+
+    changed = sorted(f for f in inputs if old_inputs.get(f) != inputs[f])
+    removed = sorted(set(old_inputs) - set(inputs))
+    logging.info(f"Changed: {changed if changed else '-'}, removed: {removed if removed else '-'}")
+
+    if args.backup:
+        backup_project(project_folder)
+
+    scan_cache = {'old': cache.get('scans', {}), 'new': {}}
+    stage = tempfile.mkdtemp(prefix="arduinoIDE2platformIO_")
+    try:
+        stage_folder = os.path.join(stage, project_name)
+        stage_src = os.path.join(stage_folder, "src")
+        stage_include = os.path.join(stage_folder, "include")
+        recreate_pio_folders(stage_folder, stage_src, stage_include)
+        convert_project(project_folder, project_name, stage_folder, stage_src, stage_include,
+                        args, scan_cache)
+        os.makedirs(pio_folder, exist_ok=True)
+        outputs = sync_tree(stage_folder, pio_folder, old_outputs)
+    finally:
+        shutil.rmtree(stage, ignore_errors=True)
+
+    with open(cache_path, 'w') as f:
+        json.dump({'version': CACHE_VERSION, 'options': options, 'inputs': inputs,
+                   'outputs': outputs, 'scans': scan_cache['new']}, f, indent=1, sort_keys=True)
+
 #------------------------------------------------------------------------------------------------------
 def main():
     setup_logging()
     args = parse_arguments()
 
-    if args.backup:
-        backup_project(args.project_dir)
-
     try:
         project_folder, project_name, pio_folder, pio_src, pio_include = get_project_info(args.project_dir)
 
@@ -893,38 +1371,21 @@ def main():
         logging.info(f"PlatformIO src folder: {pio_src}")
         logging.info(f"PlatformIO include folder: {pio_include}\n")
 
+        if args.incremental:
+            convert_incremental(project_folder, project_name, pio_folder, args)
+            logging.info("Arduino to PlatformIO conversion completed successfully")
+            return
+
+        if args.backup:
+            backup_project(args.project_dir)
+
         recreate_pio_folders(pio_folder, pio_src, pio_include)
 
         if not os.path.exists(pio_folder):
             logging.error(f"PlatformIO folder does not exist: {pio_folder}")
             return
 
-        copy_project_files(project_folder, pio_src, pio_include)
-        copy_data_folder(project_folder, pio_folder)
-        create_platformio_ini(pio_folder)
-        extract_and_comment_defines(pio_folder, pio_include)
-        create_header_files(pio_src, pio_include, project_name)
-
-        original_header_content = preserve_original_header(pio_include, project_name)
-        #logging.info(f"original {project_name}.h:\n{original_header_content}\n\n")
-
-        global_vars = extract_global_vars(pio_src, pio_include, project_name)
-        class_instances = extract_class_instances(pio_src, pio_include, project_name)
-        logging.debug(f"Extracted global vars: {global_vars}")
-        print_global_vars(global_vars)
-        logging.debug(f"Extracted class instances: {class_instances}")
-        print_class_instances(class_instances)
-
-        process_ino_files(pio_src, pio_include, project_name, global_vars, class_instances)
-
-        process_function_references(pio_src, pio_include)
-
-        # Process the main project header file last
-        ##original_header_content = preserve_original_header(pio_include, project_name)
-        #logging.info(f"original {project_name}.h:\n{original_header_content}\n\n")
-        update_project_header(pio_include, project_name, original_header_content)
-        main_header_path = os.path.join(pio_include, f"{project_name}.h")
-        fix_main_header_file(main_header_path, project_name)
+        convert_project(project_folder, project_name, pio_folder, pio_src, pio_include, args)
 
         logging.info("Arduino to PlatformIO conversion completed successfully")
 